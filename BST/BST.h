@@ -2,19 +2,45 @@
 #define BST_H
 
 
-#include <stack>
+#include "../hash_table/node_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
 #include <iostream>
 
 
+// NONE keeps the plain unbalanced tree; RED_BLACK and AVL rotate on put and remove so the
+// height stays O(log n) whatever the insertion order
+enum class BalanceMode { NONE, RED_BLACK, AVL };
+
+
 template<typename K, typename V>
 struct node {
     K key;
     V value;
     node* right;
     node* left;
+    node* parent;
+    // entries in the subtree rooted here, for rank and select
+    int count;
+    // AVL only: height of the subtree rooted here, a leaf is 1. AVL heights stay below
+    // 1.44 log2(n + 2), so a byte is plenty and the node keeps its size
+    unsigned char height;
+    // RED_BLACK only
+    bool red;
+
+    node(K k, V v) : key(k), value(v), right(nullptr), left(nullptr), parent(nullptr), count(1), height(1), red(true) {}
+};
 
-    node(K k, V v) : key(k), value(v), right(nullptr), left(nullptr) {}
+
+// what an iterator yields: the key is read-only, the value is writable through a non-const tree
+template<typename K, typename V>
+struct bst_entry {
+    const K& key;
+    V& value;
 };
 
 
@@ -23,13 +49,16 @@ class BST {
 private:
     node<K, V>* _root;
     int _size;
+    BalanceMode _mode;
+    // every node lives in the pool; copies and bulk builds take one contiguous run of it
+    NodePool<node<K, V>> pool;
 
-    node<K, V>* find(K key) const {
+    node<K, V>* findNode(K key) const {
         node<K, V>* temp = _root;
-        
+
         while (temp) {
             if (key == temp->key) break;
-            
+
             if (key > temp->key) temp = temp->right;
             else temp = temp->left;
         }
@@ -37,201 +66,812 @@ private:
         return temp;
     }
 
+    // nodes go back with their slabs; the tree is walked only when K or V need destructors
     void cleanup() {
-        if (!_root) return;
+        if constexpr (!std::is_trivially_destructible<K>::value || !std::is_trivially_destructible<V>::value) {
+            node<K, V>* temp = _root;
 
-        std::stack<node<K,V>*> treeStack;
-        treeStack.push(_root);
+            // post-order through the parent pointers: a node is destroyed once both children are
+            while (temp) {
+                if (temp->left) temp = temp->left;
+                else if (temp->right) temp = temp->right;
+                else {
+                    node<K, V>* parent = temp->parent;
 
-        while (!treeStack.empty()) {
-            node<K, V>* temp = treeStack.top();
-            treeStack.pop();
+                    if (parent && parent->left == temp) parent->left = nullptr;
+                    else if (parent) parent->right = nullptr;
 
-            if (temp->left) treeStack.push(temp->left);
-            if (temp->right) treeStack.push(temp->right);
+                    temp->~node<K, V>();
+                    temp = parent;
+                }
+            }
+        }
+
+        pool.releaseAll();
+    }
+
+    // copies the shape as well as the entries, so a balanced tree stays balanced and an
+    // unbalanced one is not rebuilt by O(n) puts down a skewed path
+    void copyFrom(const BST<K, V>& other) {
+        _mode = other._mode;
 
-            delete temp;
+        // check empty assignment
+        if (!other._root) return;
+
+        void* run = pool.allocateRun(other._size);
+        int slot {0};
+
+        _root = cloneNode(other._root, nullptr, run, slot);
+        _size = other._size;
+
+        // preorder walk of both trees in step, climbing back through the parent pointers
+        const node<K, V>* source = other._root;
+        node<K, V>* target = _root;
+
+        while (source) {
+            if (source->left && !target->left) {
+                target->left = cloneNode(source->left, target, run, slot);
+                source = source->left;
+                target = target->left;
+            } else if (source->right && !target->right) {
+                target->right = cloneNode(source->right, target, run, slot);
+                source = source->right;
+                target = target->right;
+            } else {
+                source = source->parent;
+                target = target->parent;
+            }
         }
     }
 
-public:
-    BST() : _root(nullptr), _size(0) {}
+    static node<K, V>* cloneNode(const node<K, V>* source, node<K, V>* parent, void* run, int& slot) {
+        node<K, V>* n = new (NodePool<node<K, V>>::at(run, slot++)) node<K, V>(source->key, source->value);
+        n->parent = parent;
+        n->count = source->count;
+        n->height = source->height;
+        n->red = source->red;
 
-    ~BST() { cleanup(); }
+        return n;
+    }
 
-    BST(const BST<K, V>& other) : _root(nullptr), _size(0){
-        // check empty assignment
-        if (other.isEmpty()) return;
+    // links slots [lo, hi) of run, which hold keys in ascending order, into a subtree rooted at
+    // the middle one. sibling subtrees differ in size by at most one, so every level but the
+    // deepest is full: that satisfies AVL as is, and red-black with the deepest level red
+    static node<K, V>* linkBalanced(void* run, int lo, int hi, node<K, V>* parent, int depth, int redDepth) {
+        if (lo >= hi) return nullptr;
+
+        int middle = lo + (hi - lo) / 2;
+        node<K, V>* n = static_cast<node<K, V>*>(NodePool<node<K, V>>::at(run, middle));
+
+        n->parent = parent;
+        n->left = linkBalanced(run, lo, middle, n, depth + 1, redDepth);
+        n->right = linkBalanced(run, middle + 1, hi, n, depth + 1, redDepth);
+        n->red = depth == redDepth;
+        update(n);
+
+        return n;
+    }
+
+    // places the entries of [first, last), already in ascending key order, in one run of count
+    // nodes and links them; of equal keys the last one's value wins
+    template<typename It>
+    void buildSorted(It first, It last, int count) {
+        clear();
 
-        node<K, V>* temp = other._root;
+        if (count == 0) return;
 
-        std::stack<node<K, V>*> treeStack;
-        treeStack.push(temp);
+        void* run = pool.allocateRun(count);
+        int placed {0};
 
-        while (!treeStack.empty()) {
-            temp = treeStack.top();
-            treeStack.pop();
-            put(temp->key, temp->value);
+        for (It it = first; it != last; ++it) {
+            node<K, V>* previous = placed ? static_cast<node<K, V>*>(NodePool<node<K, V>>::at(run, placed - 1)) : nullptr;
 
-            if (temp->right) treeStack.push(temp->right);
-            if (temp->left) treeStack.push(temp->left);
+            // check duplicate keys
+            if (previous && it->first == previous->key) previous->value = it->second;
+            else new (NodePool<node<K, V>>::at(run, placed++)) node<K, V>(it->first, it->second);
         }
+
+        linkRun(run, count);
     }
 
-    BST<K, V>& operator=(const BST<K, V>& other) {
-        // check self-assignment
-        if (this == &other) return *this;
+    void linkRun(void* run, int count) {
+        int height {0};
+
+        for (int remaining = count; remaining > 0; remaining /= 2) height++;
+
+        // a single node is the root and stays black
+        _root = linkBalanced(run, 0, count, nullptr, 0, height > 1 ? height - 1 : -1);
+        _size = count;
+    }
+
+    template<typename It>
+    void bulkBuild(It first, It last, bool sorted) {
+        using category = typename std::iterator_traits<It>::iterator_category;
+        static_assert(std::is_base_of<std::forward_iterator_tag, category>::value, "bulk build needs a forward range");
+
+        if (sorted) {
+            // check the order before anything is torn down, counting distinct keys on the way
+            int count {0};
+
+            for (It it = first, previous = first; it != last; previous = it, ++it) {
+                if (it == first || it->first > previous->first) count++;
+                else if (!(it->first == previous->first)) throw std::invalid_argument("Keys are not sorted");
+            }
+
+            buildSorted(first, last, count);
+            return;
+        }
+
+        // place the nodes in input order and sort the run itself, which streams through one
+        // block instead of chasing iterators. until the link, count holds each entry's input
+        // position, so of equal keys the last one sorts last and is the one kept
+        int n = static_cast<int>(std::distance(first, last));
 
         clear();
 
-        // check empty assignment
-        if (other.isEmpty()) return *this;
+        if (n == 0) return;
 
-        node<K, V>* temp = other._root;
+        // a node is larger than the pool's free-list link, so the run is a plain node array
+        void* run = pool.allocateRun(n);
+        node<K, V>* nodes = static_cast<node<K, V>*>(run);
+        int i {0};
+
+        for (It it = first; it != last; ++it, ++i) {
+            new (NodePool<node<K, V>>::at(run, i)) node<K, V>(it->first, it->second);
+            nodes[i].count = i;
+        }
 
-        std::stack<node<K, V>*> treeStack;
-        treeStack.push(temp);
+        std::sort(nodes, nodes + n, [](const node<K, V>& a, const node<K, V>& b) {
+            return b.key > a.key || (a.key == b.key && a.count < b.count);
+        });
 
-        while (!treeStack.empty()) {
-            temp = treeStack.top();
-            treeStack.pop();
-            put(temp->key, temp->value);
+        int count {0};
 
-            if (temp->right) treeStack.push(temp->right);
-            if (temp->left) treeStack.push(temp->left);
+        for (i = 0; i < n; i++) {
+            // check duplicate keys
+            if (i + 1 < n && nodes[i].key == nodes[i + 1].key) continue;
+
+            if (count != i) nodes[count] = std::move(nodes[i]);
+
+            count++;
         }
 
-        return *this;
+        for (i = count; i < n; i++) pool.destroy(&nodes[i]);
+
+        linkRun(run, count);
     }
 
-    void put(K key, V value) {
-        // check first node
-        if (!_root) {
-            _root = new node<K, V>(key, value);
-            _size++;
-            return;
+    static node<K, V>* minimum(node<K, V>* n) {
+        if (n) while (n->left) n = n->left;
+
+        return n;
+    }
+
+    static node<K, V>* maximum(node<K, V>* n) {
+        if (n) while (n->right) n = n->right;
+
+        return n;
+    }
+
+    // in-order neighbours through the parent pointers: amortized O(1) per step over a full walk
+    static node<K, V>* successor(node<K, V>* n) {
+        if (n->right) return minimum(n->right);
+
+        while (n->parent && n == n->parent->right) n = n->parent;
+
+        return n->parent;
+    }
+
+    static node<K, V>* predecessor(node<K, V>* n) {
+        if (n->left) return maximum(n->left);
+
+        while (n->parent && n == n->parent->left) n = n->parent;
+
+        return n->parent;
+    }
+
+    // smallest key >= key
+    node<K, V>* lowerBoundNode(const K& key) const {
+        node<K, V>* result = nullptr;
+        node<K, V>* temp = _root;
+
+        while (temp) {
+            if (key > temp->key) temp = temp->right;
+            else {
+                result = temp;
+
+                if (key == temp->key) break;
+
+                temp = temp->left;
+            }
         }
 
+        return result;
+    }
+
+    // smallest key > key
+    node<K, V>* upperBoundNode(const K& key) const {
+        node<K, V>* result = nullptr;
         node<K, V>* temp = _root;
-        
-        while (true) {
-            // check duplicate keys
-            if (key == temp->key) {
-                temp->value = value;
-                return;
+
+        while (temp) {
+            if (temp->key > key) {
+                result = temp;
+                temp = temp->left;
+            } else temp = temp->right;
+        }
+
+        return result;
+    }
+
+    // largest key <= key
+    node<K, V>* floorNode(const K& key) const {
+        node<K, V>* result = nullptr;
+        node<K, V>* temp = _root;
+
+        while (temp) {
+            if (temp->key > key) temp = temp->left;
+            else {
+                result = temp;
+
+                if (key == temp->key) break;
+
+                temp = temp->right;
             }
+        }
+
+        return result;
+    }
+
+    static int heightOf(const node<K, V>* n) { return n ? n->height : 0; }
+
+    static int countOf(const node<K, V>* n) { return n ? n->count : 0; }
+
+    // keys below key, plus key itself when inclusive and present
+    int countBelow(const K& key, bool inclusive) const {
+        int result {0};
+        node<K, V>* temp = _root;
+
+        while (temp) {
+            if (key == temp->key) return result + countOf(temp->left) + (inclusive ? 1 : 0);
 
             if (key > temp->key) {
-                if (temp->right) temp = temp->right;
-                else {
-                    temp->right = new node<K, V>(key, value);
-                    _size++;
-                    return;
+                result += countOf(temp->left) + 1;
+                temp = temp->right;
+            } else temp = temp->left;
+        }
+
+        return result;
+    }
+
+    static bool isRed(const node<K, V>* n) { return n && n->red; }
+
+    // recomputes n's augmented fields from its children, e.g. after a rotation
+    static void update(node<K, V>* n) {
+        int left = heightOf(n->left);
+        int right = heightOf(n->right);
+
+        n->height = static_cast<unsigned char>(1 + (left > right ? left : right));
+        n->count = 1 + countOf(n->left) + countOf(n->right);
+    }
+
+    // puts replacement where n hangs from its parent (or the root)
+    void replaceChild(node<K, V>* n, node<K, V>* replacement) {
+        if (!n->parent) _root = replacement;
+        else if (n->parent->left == n) n->parent->left = replacement;
+        else n->parent->right = replacement;
+
+        if (replacement) replacement->parent = n->parent;
+    }
+
+    // both rotations return the new root of the rotated subtree
+    node<K, V>* rotateLeft(node<K, V>* n) {
+        node<K, V>* pivot = n->right;
+
+        n->right = pivot->left;
+        if (pivot->left) pivot->left->parent = n;
+
+        replaceChild(n, pivot);
+        pivot->left = n;
+        n->parent = pivot;
+
+        update(n);
+        update(pivot);
+
+        return pivot;
+    }
+
+    node<K, V>* rotateRight(node<K, V>* n) {
+        node<K, V>* pivot = n->left;
+
+        n->left = pivot->right;
+        if (pivot->right) pivot->right->parent = n;
+
+        replaceChild(n, pivot);
+        pivot->right = n;
+        n->parent = pivot;
+
+        update(n);
+        update(pivot);
+
+        return pivot;
+    }
+
+    // AVL: refresh heights from n upwards, rotating wherever the sides differ by two; stops at
+    // the first subtree whose height did not change, since nothing above it can have changed
+    void rebalanceAVL(node<K, V>* n) {
+        while (n) {
+            int before = heightOf(n);
+            update(n);
+
+            int balance = heightOf(n->left) - heightOf(n->right);
+
+            if (balance > 1) {
+                if (heightOf(n->left->left) < heightOf(n->left->right)) rotateLeft(n->left);
+
+                n = rotateRight(n);
+            } else if (balance < -1) {
+                if (heightOf(n->right->right) < heightOf(n->right->left)) rotateRight(n->right);
+
+                n = rotateLeft(n);
+            }
+
+            if (n->height == before) break;
+
+            n = n->parent;
+        }
+    }
+
+    // red-black: n was just linked in red, repair a red parent by recoloring or rotating
+    void insertFixup(node<K, V>* n) {
+        while (n != _root && n->parent->red) {
+            node<K, V>* parent = n->parent;
+            // the parent is red, so it is not the root and the grandparent exists
+            node<K, V>* grandparent = parent->parent;
+
+            if (parent == grandparent->left) {
+                node<K, V>* uncle = grandparent->right;
+
+                if (isRed(uncle)) {
+                    parent->red = false;
+                    uncle->red = false;
+                    grandparent->red = true;
+                    n = grandparent;
+                    continue;
                 }
+
+                if (n == parent->right) {
+                    rotateLeft(parent);
+                    n = parent;
+                    parent = n->parent;
+                }
+
+                parent->red = false;
+                grandparent->red = true;
+                rotateRight(grandparent);
             } else {
-                if (temp->left) temp = temp->left;
-                else {
-                    temp->left = new node<K, V>(key, value);
-                    _size++;
-                    return;
+                node<K, V>* uncle = grandparent->left;
+
+                if (isRed(uncle)) {
+                    parent->red = false;
+                    uncle->red = false;
+                    grandparent->red = true;
+                    n = grandparent;
+                    continue;
+                }
+
+                if (n == parent->left) {
+                    rotateRight(parent);
+                    n = parent;
+                    parent = n->parent;
+                }
+
+                parent->red = false;
+                grandparent->red = true;
+                rotateLeft(grandparent);
+            }
+        }
+
+        _root->red = false;
+    }
+
+    // red-black: a black node was unlinked above n, which may be null, so n's side is one
+    // black short; push the deficit up or fix it with the sibling
+    void removeFixup(node<K, V>* n, node<K, V>* parent) {
+        while (n != _root && !isRed(n)) {
+            // the short side has black height >= 1 on the other side, so the sibling exists
+            if (n == parent->left) {
+                node<K, V>* sibling = parent->right;
+
+                if (sibling->red) {
+                    sibling->red = false;
+                    parent->red = true;
+                    rotateLeft(parent);
+                    sibling = parent->right;
                 }
+
+                if (!isRed(sibling->left) && !isRed(sibling->right)) {
+                    sibling->red = true;
+                    n = parent;
+                    parent = n->parent;
+                    continue;
+                }
+
+                if (!isRed(sibling->right)) {
+                    sibling->left->red = false;
+                    sibling->red = true;
+                    sibling = rotateRight(sibling);
+                }
+
+                sibling->red = parent->red;
+                parent->red = false;
+                sibling->right->red = false;
+                rotateLeft(parent);
+            } else {
+                node<K, V>* sibling = parent->left;
+
+                if (sibling->red) {
+                    sibling->red = false;
+                    parent->red = true;
+                    rotateRight(parent);
+                    sibling = parent->left;
+                }
+
+                if (!isRed(sibling->left) && !isRed(sibling->right)) {
+                    sibling->red = true;
+                    n = parent;
+                    parent = n->parent;
+                    continue;
+                }
+
+                if (!isRed(sibling->left)) {
+                    sibling->right->red = false;
+                    sibling->red = true;
+                    sibling = rotateLeft(sibling);
+                }
+
+                sibling->red = parent->red;
+                parent->red = false;
+                sibling->left->red = false;
+                rotateRight(parent);
+            }
+
+            n = _root;
+        }
+
+        if (n) n->red = false;
+    }
+
+public:
+    // in-order iterator: a node pointer stepped through the parent links, nothing is allocated.
+    // T is V for iterator and const V for const_iterator. put and remove of other keys leave
+    // an iterator valid; removing its own key invalidates it
+    template<typename T>
+    class basic_iterator {
+    private:
+        friend class BST<K, V>;
+        template<typename> friend class basic_iterator;
+
+        node<K, V>* current;
+        // for stepping back from end()
+        const BST<K, V>* tree;
+
+        basic_iterator(node<K, V>* n, const BST<K, V>* t) : current(n), tree(t) {}
+
+    public:
+        bst_entry<K, T> operator*() const { return {current->key, current->value}; }
+
+        const K& key() const { return current->key; }
+
+        T& value() const { return current->value; }
+
+        basic_iterator& operator++() {
+            current = successor(current);
+            return *this;
+        }
+
+        basic_iterator& operator--() {
+            current = current ? predecessor(current) : maximum(tree->_root);
+            return *this;
+        }
+
+        bool operator==(const basic_iterator& other) const { return current == other.current; }
+
+        bool operator!=(const basic_iterator& other) const { return current != other.current; }
+
+        operator basic_iterator<const V>() const { return basic_iterator<const V>(current, tree); }
+    };
+
+    typedef basic_iterator<V> iterator;
+    typedef basic_iterator<const V> const_iterator;
+
+    explicit BST(BalanceMode mode = BalanceMode::NONE) : _root(nullptr), _size(0), _mode(mode) {}
+
+    // bulk constructor from a range of pairs (anything with .first and .second) in ascending
+    // key order, e.g. a sorted std::vector<std::pair<K, V>>: O(n), one contiguous run of nodes
+    // laid out in key order, perfectly balanced whatever the mode. of equal keys the last one
+    // wins, as with put. pass sorted = false to have the range sorted (and deduplicated) first,
+    // O(n log n)
+    template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    BST(It first, It last, BalanceMode mode = BalanceMode::NONE, bool sorted = true)
+        : _root(nullptr), _size(0), _mode(mode) { bulkBuild(first, last, sorted); }
+
+    ~BST() { cleanup(); }
+
+    BST(const BST<K, V>& other) : _root(nullptr), _size(0), _mode(other._mode) { copyFrom(other); }
+
+    BST<K, V>& operator=(const BST<K, V>& other) {
+        // check self-assignment
+        if (this == &other) return *this;
+
+        clear();
+        copyFrom(other);
+
+        return *this;
+    }
+
+    // replaces the contents with a bulk build of [first, last), keeping the mode. a range that
+    // claims to be sorted but is not throws std::invalid_argument and leaves the tree untouched
+    template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    void assign(It first, It last, bool sorted = true) { bulkBuild(first, last, sorted); }
+
+    void put(K key, V value) {
+        node<K, V>* parent = nullptr;
+        node<K, V>* temp = _root;
+
+        while (temp) {
+            // check duplicate keys
+            if (key == temp->key) {
+                temp->value = value;
+                return;
             }
+
+            parent = temp;
+
+            if (key > temp->key) temp = temp->right;
+            else temp = temp->left;
         }
+
+        temp = pool.create(key, value);
+        temp->parent = parent;
+        _size++;
+
+        // check first node
+        if (!parent) _root = temp;
+        else if (key > parent->key) parent->right = temp;
+        else parent->left = temp;
+
+        // every subtree on the path gained the entry; rotations below recount from children
+        for (node<K, V>* ancestor = parent; ancestor; ancestor = ancestor->parent) ancestor->count++;
+
+        if (_mode == BalanceMode::RED_BLACK) insertFixup(temp);
+        else if (_mode == BalanceMode::AVL) rebalanceAVL(parent);
     }
 
     V get(K key) const {
-        node<K, V>* temp = find(key);
+        node<K, V>* temp = findNode(key);
 
         if (temp) return temp->value;
         else throw std::out_of_range("Key not found");
     }
 
+    // non-throwing lookups: a miss costs the same as a hit
+    V* find(K key) {
+        node<K, V>* temp = findNode(key);
+
+        return temp ? &temp->value : nullptr;
+    }
+
+    const V* find(K key) const {
+        node<K, V>* temp = findNode(key);
+
+        return temp ? &temp->value : nullptr;
+    }
+
+    bool tryGet(K key, V& out) const {
+        node<K, V>* temp = findNode(key);
+
+        if (!temp) return false;
+
+        out = temp->value;
+        return true;
+    }
+
+    V getOrDefault(K key, V value) const {
+        node<K, V>* temp = findNode(key);
+
+        return temp ? temp->value : value;
+    }
+
     bool contains(K key) const {
-        node<K, V>* temp = find(key);
+        node<K, V>* temp = findNode(key);
 
         if (temp) return true;
         else return false;
     }
 
     void remove(K key) {
-        node<K, V>* temp1 = _root;
-        node<K, V>* tracker = _root;
+        node<K, V>* temp = findNode(key);
 
-        while (temp1) {
-            if (key == temp1->key) break;
-            
-            if (key > temp1->key) {
-                temp1 = temp1->right;
+        if (!temp) throw std::out_of_range("Key not found");
 
-                if (temp1 && key != temp1->key) tracker = tracker->right;
-            }
-            else {
-                temp1 = temp1->left;
+        _size--;
 
-                if (temp1 && key != temp1->key) tracker = tracker->left;
-            }
+        // the node that takes the removed one's place, and where it hangs: the deficit of a
+        // red-black removal and the height change of an AVL removal both start there
+        node<K, V>* child;
+        node<K, V>* parent;
+        bool removedRed = temp->red;
+
+        // in case of no left child
+        if (!temp->left) {
+            child = temp->right;
+            parent = temp->parent;
+            replaceChild(temp, child);
         }
+        // in case of no right child
+        else if (!temp->right) {
+            child = temp->left;
+            parent = temp->parent;
+            replaceChild(temp, child);
+        } else {
+            // relink the in-order successor in the removed node's place
+            node<K, V>* successor = temp->right;
 
-        if (!temp1) throw std::out_of_range("Key not found");
+            while (successor->left) successor = successor->left;
 
-        _size--;
+            removedRed = successor->red;
+            child = successor->right;
 
-        // in case of no right child
-        if (!temp1->right) {
-            // in case of root node
-            if (temp1 == _root) {
-                _root = temp1->left;
-                delete temp1;
-                return;
+            if (successor->parent == temp) parent = successor;
+            else {
+                parent = successor->parent;
+                replaceChild(successor, child);
+                successor->right = temp->right;
+                successor->right->parent = successor;
             }
 
-            if (tracker->right == temp1) tracker->right = temp1->left;
-            else tracker->left = temp1->left;
-
-            delete temp1;
-            return;
+            replaceChild(temp, successor);
+            successor->left = temp->left;
+            successor->left->parent = successor;
+            successor->red = temp->red;
+            successor->count = temp->count;
+            // the AVL walk may stop below this position, so the successor takes over its height
+            successor->height = temp->height;
         }
 
-        // in case of no left child
-        if (!temp1->left) {
-            // in case of root node
-            if (temp1 == _root) {
-                _root = temp1->right;
-                delete temp1;
-                return;
-            }
+        pool.destroy(temp);
 
-            if (tracker->right == temp1) tracker->right = temp1->right;
-            else tracker->left = temp1->right;
+        // every subtree from the unlinked position up lost one entry
+        for (node<K, V>* ancestor = parent; ancestor; ancestor = ancestor->parent) ancestor->count--;
 
-            delete temp1;
-            return;
-        }
+        if (_mode == BalanceMode::RED_BLACK && !removedRed) removeFixup(child, parent);
+        else if (_mode == BalanceMode::AVL) rebalanceAVL(parent);
+    }
+
+    iterator begin() { return iterator(minimum(_root), this); }
+
+    iterator end() { return iterator(nullptr, this); }
+
+    const_iterator begin() const { return const_iterator(minimum(_root), this); }
+
+    const_iterator end() const { return const_iterator(nullptr, this); }
+
+    // first entry whose key is >= key, or end()
+    iterator lowerBound(K key) { return iterator(lowerBoundNode(key), this); }
+
+    const_iterator lowerBound(K key) const { return const_iterator(lowerBoundNode(key), this); }
+
+    // first entry whose key is > key, or end()
+    iterator upperBound(K key) { return iterator(upperBoundNode(key), this); }
+
+    const_iterator upperBound(K key) const { return const_iterator(upperBoundNode(key), this); }
 
+    K min() const {
+        if (!_root) throw std::out_of_range("Tree is empty");
 
-        // find the in-order successor
-        node<K, V>* temp2 = temp1->right;
-        tracker = temp1;
+        return minimum(_root)->key;
+    }
+
+    K max() const {
+        if (!_root) throw std::out_of_range("Tree is empty");
+
+        return maximum(_root)->key;
+    }
+
+    // largest key <= key and smallest key >= key; nullptr when there is none
+    const K* floor(K key) const {
+        node<K, V>* temp = floorNode(key);
+
+        return temp ? &temp->key : nullptr;
+    }
+
+    const K* ceiling(K key) const {
+        node<K, V>* temp = lowerBoundNode(key);
+
+        return temp ? &temp->key : nullptr;
+    }
 
-        while (temp2->left) {
-            tracker = temp2;
-            temp2 = temp2->left;
+    // calls visit(key, value) for every key in [lo, hi], in order. the walk starts at the
+    // ceiling of lo and stops past hi, so subtrees outside the range are never entered:
+    // O(log n + k) for k visited entries
+    template<typename Visit>
+    void forEachInRange(K lo, K hi, Visit visit) const {
+        for (node<K, V>* temp = lowerBoundNode(lo); temp && !(temp->key > hi); temp = successor(temp)) {
+            visit(static_cast<const K&>(temp->key), static_cast<const V&>(temp->value));
         }
+    }
+
+    // number of keys below key; key itself need not be present
+    int rank(K key) const { return countBelow(key, false); }
 
-        if (tracker->right == temp2) tracker->right = temp2->right;
-        else tracker->left = temp2->right;
+    // the k-th smallest key, counting from 0: select(0) == min(), select(size() - 1) == max()
+    K select(int k) const {
+        if (k < 0 || k >= _size) throw std::out_of_range("Rank out of range");
 
-        temp1->key = temp2->key;
-        temp1->value = temp2->value;
+        node<K, V>* temp = _root;
+
+        while (true) {
+            int left = countOf(temp->left);
 
-        delete temp2;
-        return;
+            if (k == left) return temp->key;
+
+            if (k < left) temp = temp->left;
+            else {
+                k -= left + 1;
+                temp = temp->right;
+            }
+        }
+    }
+
+    // number of keys in [lo, hi], without visiting them
+    int countInRange(K lo, K hi) const {
+        if (lo > hi) return 0;
+
+        return countBelow(hi, true) - countBelow(lo, false);
     }
 
     int size() const { return _size; }
 
     bool isEmpty() const { return _size == 0; }
 
+    BalanceMode balanceMode() const { return _mode; }
+
+    // heap bytes held by the node pool (live and free nodes); memory owned by keys and values
+    // (e.g. string buffers) is not included
+    std::size_t memoryUsage() const { return sizeof(*this) + pool.bytes(); }
+
+    // longest root-to-leaf path in nodes, 0 for an empty tree
+    int height() const {
+        if (_mode == BalanceMode::AVL) return heightOf(_root);
+
+        // walk the tree through the parent pointers, no stack needed
+        int depth {0};
+        int best {0};
+        const node<K, V>* temp = _root;
+        const node<K, V>* previous = nullptr;
+
+        while (temp) {
+            const node<K, V>* next;
+
+            if (previous == temp->parent) {
+                depth++;
+
+                if (depth > best) best = depth;
+
+                next = temp->left ? temp->left : (temp->right ? temp->right : temp->parent);
+            } else if (previous == temp->left && temp->right) next = temp->right;
+            else next = temp->parent;
+
+            if (next == temp->parent) depth--;
+
+            previous = temp;
+            temp = next;
+        }
+
+        return best;
+    }
+
     void clear() {
         cleanup();
 
@@ -241,4 +881,3 @@ public:
 };
 
 #endif
-
@@ -0,0 +1,69 @@
+#include "BST.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 100'000;
+// the unbalanced tree is quadratic on sorted input, so it gets a smaller run
+const int skewedSize = 20'000;
+
+enum class Order { SORTED, REVERSE, RANDOM };
+
+int keyAt(Order order, int i, int n) {
+    if (order == Order::SORTED) return i;
+    if (order == Order::REVERSE) return n - 1 - i;
+
+    // a permutation of 0..n-1 when n is not a multiple of the multiplier's factors
+    return static_cast<int>((i * 2654435761ULL) % n);
+}
+
+// inserts, looks up and removes n keys in the given order; prints the time of each phase
+void run(const char* name, BalanceMode mode, Order order, int n) {
+    using namespace std::chrono;
+
+    BST<int, int> tree(mode);
+    long long sum {0};
+
+    auto start1 = high_resolution_clock::now();
+
+    for (int i = 0; i < n; i++) tree.put(keyAt(order, i, n), i);
+
+    auto end1 = high_resolution_clock::now();
+
+    int height = tree.height();
+
+    auto start2 = high_resolution_clock::now();
+
+    for (int i = 0; i < n; i++) sum += tree.getOrDefault(keyAt(order, i, n), 0);
+
+    auto end2 = high_resolution_clock::now();
+    auto start3 = high_resolution_clock::now();
+
+    for (int i = 0; i < n; i++) tree.remove(keyAt(order, i, n));
+
+    auto end3 = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    std::cout << name << n << "      " << height << "      "
+              << duration_cast<nanoseconds>(end1 - start1).count() / n << "      "
+              << duration_cast<nanoseconds>(end2 - start2).count() / n << "      "
+              << duration_cast<nanoseconds>(end3 - start3).count() / n << "\n";
+}
+
+int main() {
+    const char* orders[] {"sorted", "reverse", "random"};
+    const Order values[] {Order::SORTED, Order::REVERSE, Order::RANDOM};
+
+    for (int o = 0; o < 3; o++) {
+        std::cout << "\n" << orders[o] << " insertion\n";
+        std::cout << "mode        keys      height  put (ns)  get (ns)  remove (ns)\n";
+
+        int unbalanced = values[o] == Order::RANDOM ? size : skewedSize;
+
+        run("NONE        ", BalanceMode::NONE, values[o], unbalanced);
+        run("RED_BLACK   ", BalanceMode::RED_BLACK, values[o], size);
+        run("AVL         ", BalanceMode::AVL, values[o], size);
+    }
+
+    return 0;
+}
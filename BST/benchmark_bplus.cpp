@@ -0,0 +1,85 @@
+#include "BST.h"
+#include "bplus_tree.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 10'000'000;
+const int lookups = 5'000'000;
+
+template<typename Tree>
+void run(const char* name, Tree& tree, const int* keys) {
+    using namespace std::chrono;
+
+    auto start1 = high_resolution_clock::now();
+
+    for (int i = 0; i < size; i++) tree.put(keys[i], i);
+
+    auto end1 = high_resolution_clock::now();
+
+    // random hits (even keys) and misses (odd keys)
+    unsigned long long state {1};
+    long long sum {0};
+
+    auto start2 = high_resolution_clock::now();
+
+    for (int i = 0; i < lookups; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        sum += tree.getOrDefault(static_cast<int>((state >> 33) % size) * 2, 0);
+    }
+
+    auto end2 = high_resolution_clock::now();
+    auto start3 = high_resolution_clock::now();
+
+    for (int i = 0; i < lookups; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        sum += tree.getOrDefault(static_cast<int>((state >> 33) % size) * 2 + 1, 0);
+    }
+
+    auto end3 = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    std::cout << name << tree.height() << "       "
+              << duration_cast<nanoseconds>(end1 - start1).count() / size << "        "
+              << duration_cast<nanoseconds>(end2 - start2).count() / lookups << "        "
+              << duration_cast<nanoseconds>(end3 - start3).count() / lookups << "         "
+              << static_cast<double>(tree.memoryUsage()) / size << "\n";
+}
+
+int main() {
+    // even keys 0..2(size-1) in shuffled order
+    int* keys = new int[size];
+    unsigned long long seed {7};
+
+    for (int i = 0; i < size; i++) keys[i] = 2 * i;
+
+    for (int i = size - 1; i > 0; i--) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        int j = static_cast<int>((seed >> 33) % (i + 1));
+        int temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+
+    std::cout << "10M int keys, random order\n";
+    std::cout << "tree        height  put (ns)  hit (ns)  miss (ns)  bytes/entry\n";
+
+    {
+        BST<int, int> tree(BalanceMode::RED_BLACK);
+        run("RED_BLACK   ", tree, keys);
+    }
+
+    {
+        BST<int, int> tree(BalanceMode::AVL);
+        run("AVL         ", tree, keys);
+    }
+
+    {
+        BPlusTree<int, int> tree;
+        run("B+ tree     ", tree, keys);
+    }
+
+    delete[] keys;
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "BST.h"
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+const int size = 20'000'000;
+
+// one in-order pass over every entry, in ms
+long long scanMs(const BST<long long, int>& tree) {
+    using namespace std::chrono;
+
+    long long sum {0};
+    auto start = high_resolution_clock::now();
+
+    for (auto entry : tree) sum += entry.value;
+
+    auto end = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    return duration_cast<milliseconds>(end - start).count();
+}
+
+int main() {
+    using namespace std::chrono;
+
+    // the nightly reload: sorted sequence IDs
+    std::vector<std::pair<long long, int>> sorted;
+    sorted.reserve(size);
+
+    for (int i = 0; i < size; i++) sorted.push_back({1'000'000'000LL + 3LL * i, i});
+
+    std::cout << "20M sorted keys           build (ms)  height  in-order pass (ms)\n";
+
+    const char* names[] {"put, RED_BLACK           ", "put, AVL                 "};
+    const BalanceMode modes[] {BalanceMode::RED_BLACK, BalanceMode::AVL};
+
+    for (int m = 0; m < 2; m++) {
+        auto start = high_resolution_clock::now();
+
+        BST<long long, int> tree(modes[m]);
+
+        for (const auto& p : sorted) tree.put(p.first, p.second);
+
+        auto end = high_resolution_clock::now();
+
+        std::cout << names[m] << duration_cast<milliseconds>(end - start).count() << "        "
+                  << tree.height() << "      " << scanMs(tree) << "\n";
+    }
+
+    {
+        auto start = high_resolution_clock::now();
+
+        BST<long long, int> tree(sorted.begin(), sorted.end(), BalanceMode::RED_BLACK);
+
+        auto end = high_resolution_clock::now();
+
+        std::cout << "bulk build, sorted        " << duration_cast<milliseconds>(end - start).count() << "        "
+                  << tree.height() << "      " << scanMs(tree) << "\n";
+    }
+
+    // the same keys shuffled, with sorted = false
+    std::vector<std::pair<long long, int>> shuffled(sorted);
+    unsigned long long state {7};
+
+    for (int i = size - 1; i > 0; i--) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::swap(shuffled[i], shuffled[(state >> 33) % (i + 1)]);
+    }
+
+    {
+        auto start = high_resolution_clock::now();
+
+        BST<long long, int> tree(shuffled.begin(), shuffled.end(), BalanceMode::RED_BLACK, false);
+
+        auto end = high_resolution_clock::now();
+
+        std::cout << "bulk build, unsorted      " << duration_cast<milliseconds>(end - start).count() << "        "
+                  << tree.height() << "      " << scanMs(tree) << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "BST.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 100'000;
+const int lookups = 1'000'000;
+
+// exception-driven lookup: every miss throws and unwinds
+int exceptionGetOrDefault(const BST<int, int>& tree, int key, int value) {
+    try {
+        return tree.get(key);
+    } catch (const std::out_of_range&) {
+        return value;
+    }
+}
+
+template<typename Lookup>
+double nsPerLookup(Lookup lookup, int offset) {
+    using namespace std::chrono;
+
+    long long sum = 0;
+    auto start = high_resolution_clock::now();
+
+    // keys >= size miss, keys < size hit
+    for (int i = 0; i < lookups; i++) sum += lookup(offset + i % size);
+
+    auto end = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    return duration_cast<nanoseconds>(end - start).count() / static_cast<double>(lookups);
+}
+
+int main() {
+    BST<int, int> tree;
+
+    // insert in a scrambled order so the unbalanced tree stays shallow
+    for (int i = 0; i < size; i++) tree.put(static_cast<int>((i * 2654435761ULL) % size), i);
+
+    auto throwing = [&tree](int key) { return exceptionGetOrDefault(tree, key, -1); };
+    auto direct = [&tree](int key) { return tree.getOrDefault(key, -1); };
+    auto pointer = [&tree](int key) { const int* v = tree.find(key); return v ? *v : -1; };
+
+    std::cout << "                      hit (ns)   miss (ns)\n";
+    std::cout << "try/catch get         " << nsPerLookup(throwing, 0) << "    " << nsPerLookup(throwing, size) << "\n";
+    std::cout << "getOrDefault          " << nsPerLookup(direct, 0) << "    " << nsPerLookup(direct, size) << "\n";
+    std::cout << "find                  " << nsPerLookup(pointer, 0) << "    " << nsPerLookup(pointer, size) << "\n";
+
+    return 0;
+}
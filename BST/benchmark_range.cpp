@@ -0,0 +1,122 @@
+#include "BST.h"
+#include "bplus_tree.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+const int size = 1'000'000;
+// every width scans about this many entries in total
+const int visitsPerWidth = 20'000'000;
+
+unsigned long long state {1};
+
+int randomKey() {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<int>((state >> 33) % size);
+}
+
+// scans random ranges of the given width with scan(lo, hi, sum); prints million entries per second
+// and nanoseconds per range
+template<typename Scan>
+void run(const char* name, int width, Scan scan) {
+    using namespace std::chrono;
+
+    int queries = visitsPerWidth / width;
+    long long sum {0};
+    long long visited {0};
+
+    auto start = high_resolution_clock::now();
+
+    for (int i = 0; i < queries; i++) {
+        int lo = randomKey();
+        visited += scan(lo, lo + width - 1, sum);
+    }
+
+    auto end = high_resolution_clock::now();
+    double ns = static_cast<double>(duration_cast<nanoseconds>(end - start).count());
+
+    if (sum == 42) std::cout << "";
+
+    std::cout << name << "  " << width << "        " << visited / (ns / 1e3) << "        " << ns / queries << "\n";
+}
+
+int main() {
+    using namespace std::chrono;
+
+    // keys 0..size-1 in shuffled order
+    int* keys = new int[size];
+
+    for (int i = 0; i < size; i++) keys[i] = i;
+
+    for (int i = size - 1; i > 0; i--) {
+        int j = randomKey() % (i + 1);
+        std::swap(keys[i], keys[j]);
+    }
+
+    BST<int, int> tree(BalanceMode::RED_BLACK);
+    BPlusTree<int, int> bplus;
+
+    for (int i = 0; i < size; i++) {
+        tree.put(keys[i], i);
+        bplus.put(keys[i], i);
+    }
+
+    std::cout << "scan                    width     Mkeys/s     ns/range\n";
+
+    const int widths[] {10, 1000, 100'000};
+
+    for (int width : widths) {
+        run("forEachInRange        ", width, [&tree](int lo, int hi, long long& sum) {
+            int count {0};
+            tree.forEachInRange(lo, hi, [&sum, &count](int, int value) {
+                sum += value;
+                count++;
+            });
+            return count;
+        });
+
+        run("lowerBound + ++       ", width, [&tree](int lo, int hi, long long& sum) {
+            int count {0};
+
+            for (auto it = tree.lowerBound(lo); it != tree.end() && it.key() <= hi; ++it) {
+                sum += it.value();
+                count++;
+            }
+
+            return count;
+        });
+
+        run("B+ tree forEachInRange", width, [&bplus](int lo, int hi, long long& sum) {
+            int count {0};
+            bplus.forEachInRange(lo, hi, [&sum, &count](int, int value) {
+                sum += value;
+                count++;
+            });
+            return count;
+        });
+    }
+
+    // the old workaround, sorting a side copy of the keys, against one in-order pass
+    int* scratch = new int[size];
+    auto start1 = high_resolution_clock::now();
+
+    int filled {0};
+    for (auto entry : tree) scratch[filled++] = entry.key;
+
+    auto end1 = high_resolution_clock::now();
+    auto start2 = high_resolution_clock::now();
+
+    for (int i = 0; i < size; i++) scratch[i] = keys[i];
+
+    std::sort(scratch, scratch + size);
+
+    auto end2 = high_resolution_clock::now();
+
+    std::cout << "\nall keys in order, in-order pass:    " << duration_cast<milliseconds>(end1 - start1).count() << " ms\n";
+    std::cout << "all keys in order, copy and sort:    " << duration_cast<milliseconds>(end2 - start2).count() << " ms\n";
+
+    delete[] scratch;
+    delete[] keys;
+
+    return 0;
+}
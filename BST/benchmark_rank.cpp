@@ -0,0 +1,76 @@
+#include "BST.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 1'000'000;
+const int queries = 1'000'000;
+const int scans = 20;
+
+unsigned long long state {1};
+
+int randomKey() {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<int>((state >> 33) % size);
+}
+
+int main() {
+    using namespace std::chrono;
+
+    BST<int, int> tree(BalanceMode::RED_BLACK);
+
+    for (int i = 0; i < size; i++) tree.put(randomKey() * 2, i);
+
+    long long sum {0};
+
+    // the monitoring loop before: walk the keys to answer "how many below X" and "99th percentile"
+    auto start1 = high_resolution_clock::now();
+
+    for (int i = 0; i < scans; i++) {
+        int bound = randomKey() * 2;
+        int below {0};
+        tree.forEachInRange(tree.min(), bound - 1, [&below](int, int) { below++; });
+
+        int target = tree.size() * 99 / 100;
+        int position {0};
+
+        for (auto it = tree.begin(); it != tree.end(); ++it, ++position) {
+            if (position == target) {
+                sum += below + it.key();
+                break;
+            }
+        }
+    }
+
+    auto end1 = high_resolution_clock::now();
+
+    // the same two answers from the subtree counts
+    auto start2 = high_resolution_clock::now();
+
+    for (int i = 0; i < queries; i++) {
+        int bound = randomKey() * 2;
+        sum += tree.rank(bound) + tree.select(tree.size() * 99 / 100);
+    }
+
+    auto end2 = high_resolution_clock::now();
+
+    auto start3 = high_resolution_clock::now();
+
+    for (int i = 0; i < queries; i++) {
+        int lo = randomKey() * 2;
+        sum += tree.countInRange(lo, lo + 20'000);
+    }
+
+    auto end3 = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    std::cout << tree.size() << " keys\n";
+    std::cout << "rank + percentile, by scanning:      "
+              << duration_cast<microseconds>(end1 - start1).count() / scans << " us\n";
+    std::cout << "rank + percentile, by rank/select:   "
+              << duration_cast<nanoseconds>(end2 - start2).count() / queries << " ns\n";
+    std::cout << "countInRange, 20000-wide range:      "
+              << duration_cast<nanoseconds>(end3 - start3).count() / queries << " ns\n";
+
+    return 0;
+}
@@ -0,0 +1,684 @@
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+
+#include <cstddef>
+#include <stdexcept>
+
+
+// byte budget of one node's key/value (leaf) or key/child (inner) arrays
+static const int BPLUS_NODE_BYTES {512};
+static const int BPLUS_MIN_SLOTS {8};
+// inner nodes have at least two children, so this bounds any tree with int-sized counts
+static const int BPLUS_MAX_HEIGHT {32};
+static const int BPLUS_CACHE_LINE {64};
+
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BPLUS_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define BPLUS_PREFETCH(addr) ((void)(addr))
+#endif
+
+
+constexpr int bplusSlots(std::size_t entryBytes) {
+    return static_cast<int>(BPLUS_NODE_BYTES / entryBytes) < BPLUS_MIN_SLOTS
+        ? BPLUS_MIN_SLOTS
+        : static_cast<int>(BPLUS_NODE_BYTES / entryBytes);
+}
+
+
+// entries live only in leaves, sorted, keys apart from values so a search reads only keys
+template<typename K, typename V, int N>
+struct bplus_leaf {
+    int count;
+    bplus_leaf* next;
+    bplus_leaf* prev;
+    K keys[N];
+    V values[N];
+
+    bplus_leaf() : count(0), next(nullptr), prev(nullptr) {}
+};
+
+
+// keys under children[i] are below keys[i], keys under children[i + 1] are not; children are
+// leaves at the lowest level
+template<typename K, int N>
+struct bplus_inner {
+    int count;
+    K keys[N];
+    void* children[N + 1];
+
+    bplus_inner() : count(0) {}
+};
+
+
+// ordered map with the BST interface, stored as a B+ tree: a node holds tens of keys in one
+// array, so a lookup touches height() nodes instead of ~log2(n) scattered ones, and an entry
+// costs its key and value plus a share of the node instead of a heap node with three pointers
+template<typename K, typename V>
+class BPlusTree {
+private:
+    static const int LEAF_SLOTS = bplusSlots(sizeof(K) + sizeof(V));
+    static const int INNER_SLOTS = bplusSlots(sizeof(K) + sizeof(void*));
+    static const int LEAF_MIN = LEAF_SLOTS / 2;
+    static const int INNER_MIN = (INNER_SLOTS - 1) / 2;
+
+    typedef bplus_leaf<K, V, LEAF_SLOTS> leaf;
+    typedef bplus_inner<K, INNER_SLOTS> inner;
+
+    // a leaf when _height is 0, otherwise an inner node
+    void* _root;
+    // inner levels above the leaves
+    int _height;
+    int _size;
+    int _leaves;
+    int _inners;
+    leaf* _first;
+
+    // both searches are branch-free: the loop runs ceil(log2(count)) times whatever the key,
+    // and the step compiles to a conditional move instead of a mispredicted jump
+
+    // first slot whose key is not below key
+    static int lowerBound(const K* keys, int count, const K& key) {
+        if (count == 0) return 0;
+
+        const K* base = keys;
+
+        while (count > 1) {
+            int half = count / 2;
+            base = key > base[half] ? base + half : base;
+            count -= half;
+        }
+
+        return static_cast<int>(base - keys) + (key > *base);
+    }
+
+    // first slot whose key is above key, i.e. the child to descend into
+    static int upperBound(const K* keys, int count, const K& key) {
+        if (count == 0) return 0;
+
+        const K* base = keys;
+
+        while (count > 1) {
+            int half = count / 2;
+            base = base[half] > key ? base : base + half;
+            count -= half;
+        }
+
+        return static_cast<int>(base - keys) + !(*base > key);
+    }
+
+    // a binary search over a node's keys would miss once per cache line it reaches, one line
+    // after the other; requesting all of them first lets the misses overlap
+    static void prefetchKeys(const K* keys, int count) {
+        const char* first = reinterpret_cast<const char*>(keys);
+        const char* end = reinterpret_cast<const char*>(keys + count);
+
+        for (const char* line = first; line < end; line += BPLUS_CACHE_LINE) BPLUS_PREFETCH(line);
+    }
+
+    leaf* findLeaf(const K& key) const {
+        void* temp = _root;
+
+        for (int level = _height; level > 0; level--) {
+            inner* n = static_cast<inner*>(temp);
+            prefetchKeys(n->keys, n->count);
+            temp = n->children[upperBound(n->keys, n->count, key)];
+        }
+
+        return static_cast<leaf*>(temp);
+    }
+
+    V* findValue(const K& key) const {
+        if (!_root) return nullptr;
+
+        leaf* l = findLeaf(key);
+        prefetchKeys(l->keys, l->count);
+        int slot = lowerBound(l->keys, l->count, key);
+
+        if (slot < l->count && l->keys[slot] == key) return &l->values[slot];
+
+        return nullptr;
+    }
+
+    // the caller guarantees room
+    static void insertAt(leaf* l, int slot, const K& key, const V& value) {
+        for (int i = l->count; i > slot; i--) {
+            l->keys[i] = l->keys[i - 1];
+            l->values[i] = l->values[i - 1];
+        }
+
+        l->keys[slot] = key;
+        l->values[slot] = value;
+        l->count++;
+    }
+
+    static void insertAt(inner* n, int slot, const K& key, void* child) {
+        for (int i = n->count; i > slot; i--) {
+            n->keys[i] = n->keys[i - 1];
+            n->children[i + 1] = n->children[i];
+        }
+
+        n->keys[slot] = key;
+        n->children[slot + 1] = child;
+        n->count++;
+    }
+
+    // drops keys[slot] and the child to its right
+    static void eraseAt(inner* n, int slot) {
+        for (int i = slot; i < n->count - 1; i++) {
+            n->keys[i] = n->keys[i + 1];
+            n->children[i + 1] = n->children[i + 2];
+        }
+
+        n->count--;
+    }
+
+    // splits a full leaf and inserts into the proper half; returns the new right leaf.
+    // appending past the last key keeps the old leaf full and starts the right one with the
+    // new key alone, so sorted input packs leaves completely instead of leaving them half
+    // empty; prepending before the first key does the same the other way round
+    leaf* splitLeaf(leaf* l, int slot, const K& key, const V& value, bool appending, bool prepending) {
+        leaf* right = new leaf();
+        _leaves++;
+
+        int keep = appending ? l->count : (prepending ? 0 : (l->count + 1) / 2);
+
+        for (int i = keep; i < l->count; i++) {
+            right->keys[i - keep] = l->keys[i];
+            right->values[i - keep] = l->values[i];
+        }
+
+        right->count = l->count - keep;
+        l->count = keep;
+        right->next = l->next;
+        right->prev = l;
+        l->next = right;
+
+        if (right->next) right->next->prev = right;
+
+        if (slot <= keep && keep < LEAF_SLOTS) insertAt(l, slot, key, value);
+        else insertAt(right, slot - keep, key, value);
+
+        return right;
+    }
+
+    // splits a full inner node around a promoted key and inserts (key, child) into the proper
+    // half; returns the new right node, the promoted key goes out through separator
+    inner* splitInner(inner* n, int slot, const K& key, void* child, bool appending, bool prepending, K& separator) {
+        inner* right = new inner();
+        _inners++;
+
+        // keys[0, middle) stay, keys[middle] moves up, the rest go right
+        int middle = appending ? n->count - 1 : (prepending ? 0 : n->count / 2);
+
+        for (int i = middle + 1; i < n->count; i++) {
+            right->keys[i - middle - 1] = n->keys[i];
+            right->children[i - middle - 1] = n->children[i];
+        }
+
+        right->children[n->count - middle - 1] = n->children[n->count];
+        right->count = n->count - middle - 1;
+        separator = n->keys[middle];
+        n->count = middle;
+
+        if (slot <= middle) insertAt(n, slot, key, child);
+        else insertAt(right, slot - middle - 1, key, child);
+
+        return right;
+    }
+
+    // refills the leaf at children[slot] of parent, which fell below LEAF_MIN, by merging it
+    // with a sibling or by moving entries over so both halves are at least LEAF_MIN; returns
+    // true on a merge, which takes a key out of parent
+    bool fixLeaf(inner* parent, int slot) {
+        int separator = slot < parent->count ? slot : slot - 1;
+        leaf* left = static_cast<leaf*>(parent->children[separator]);
+        leaf* right = static_cast<leaf*>(parent->children[separator + 1]);
+
+        if (left->count + right->count <= LEAF_SLOTS) {
+            for (int i = 0; i < right->count; i++) {
+                left->keys[left->count + i] = right->keys[i];
+                left->values[left->count + i] = right->values[i];
+            }
+
+            left->count += right->count;
+            left->next = right->next;
+
+            if (left->next) left->next->prev = left;
+            delete right;
+            _leaves--;
+            eraseAt(parent, separator);
+            return true;
+        }
+
+        int target = (left->count + right->count) / 2;
+
+        if (left->count > target) {
+            int moved = left->count - target;
+
+            for (int i = right->count - 1; i >= 0; i--) {
+                right->keys[i + moved] = right->keys[i];
+                right->values[i + moved] = right->values[i];
+            }
+
+            for (int i = 0; i < moved; i++) {
+                right->keys[i] = left->keys[target + i];
+                right->values[i] = left->values[target + i];
+            }
+
+            left->count = target;
+            right->count += moved;
+        } else {
+            int moved = target - left->count;
+
+            for (int i = 0; i < moved; i++) {
+                left->keys[left->count + i] = right->keys[i];
+                left->values[left->count + i] = right->values[i];
+            }
+
+            for (int i = moved; i < right->count; i++) {
+                right->keys[i - moved] = right->keys[i];
+                right->values[i - moved] = right->values[i];
+            }
+
+            left->count = target;
+            right->count -= moved;
+        }
+
+        parent->keys[separator] = right->keys[0];
+
+        return false;
+    }
+
+    // the same for an inner child, with the parent's separator rotating through
+    bool fixInner(inner* parent, int slot) {
+        int separator = slot < parent->count ? slot : slot - 1;
+        inner* left = static_cast<inner*>(parent->children[separator]);
+        inner* right = static_cast<inner*>(parent->children[separator + 1]);
+
+        if (left->count + right->count + 1 <= INNER_SLOTS) {
+            left->keys[left->count] = parent->keys[separator];
+
+            for (int i = 0; i < right->count; i++) {
+                left->keys[left->count + 1 + i] = right->keys[i];
+                left->children[left->count + 1 + i] = right->children[i];
+            }
+
+            left->children[left->count + 1 + right->count] = right->children[right->count];
+            left->count += right->count + 1;
+            delete right;
+            _inners--;
+            eraseAt(parent, separator);
+            return true;
+        }
+
+        int target = (left->count + right->count) / 2;
+
+        if (left->count > target) {
+            int moved = left->count - target;
+
+            right->children[right->count + moved] = right->children[right->count];
+
+            for (int i = right->count - 1; i >= 0; i--) {
+                right->keys[i + moved] = right->keys[i];
+                right->children[i + moved] = right->children[i];
+            }
+
+            // the separator comes down as the last moved key, left's key at target goes up
+            right->keys[moved - 1] = parent->keys[separator];
+            right->children[moved - 1] = left->children[left->count];
+
+            for (int i = 0; i < moved - 1; i++) {
+                right->keys[i] = left->keys[target + 1 + i];
+                right->children[i] = left->children[target + 1 + i];
+            }
+
+            parent->keys[separator] = left->keys[target];
+            left->count = target;
+            right->count += moved;
+        } else {
+            int moved = target - left->count;
+
+            left->keys[left->count] = parent->keys[separator];
+            left->children[left->count + 1] = right->children[0];
+
+            for (int i = 0; i < moved - 1; i++) {
+                left->keys[left->count + 1 + i] = right->keys[i];
+                left->children[left->count + 2 + i] = right->children[i + 1];
+            }
+
+            parent->keys[separator] = right->keys[moved - 1];
+
+            for (int i = moved; i < right->count; i++) {
+                right->keys[i - moved] = right->keys[i];
+                right->children[i - moved] = right->children[i];
+            }
+
+            right->children[right->count - moved] = right->children[right->count];
+            left->count = target;
+            right->count -= moved;
+        }
+
+        return false;
+    }
+
+    void cleanup(void* n, int level) {
+        if (level > 0) {
+            inner* temp = static_cast<inner*>(n);
+
+            for (int i = 0; i <= temp->count; i++) cleanup(temp->children[i], level - 1);
+
+            delete temp;
+        } else delete static_cast<leaf*>(n);
+    }
+
+    // previous is the last leaf copied so far, for relinking the leaf chain in order
+    void* copyNode(const void* n, int level, leaf*& previous) {
+        if (level == 0) {
+            const leaf* source = static_cast<const leaf*>(n);
+            leaf* l = new leaf();
+
+            for (int i = 0; i < source->count; i++) {
+                l->keys[i] = source->keys[i];
+                l->values[i] = source->values[i];
+            }
+
+            l->count = source->count;
+
+            l->prev = previous;
+
+            if (previous) previous->next = l;
+            else _first = l;
+
+            previous = l;
+            return l;
+        }
+
+        const inner* source = static_cast<const inner*>(n);
+        inner* temp = new inner();
+
+        for (int i = 0; i < source->count; i++) temp->keys[i] = source->keys[i];
+
+        for (int i = 0; i <= source->count; i++) temp->children[i] = copyNode(source->children[i], level - 1, previous);
+
+        temp->count = source->count;
+        return temp;
+    }
+
+    void copyFrom(const BPlusTree<K, V>& other) {
+        // check empty assignment
+        if (!other._root) return;
+
+        leaf* previous = nullptr;
+        _root = copyNode(other._root, other._height, previous);
+        _height = other._height;
+        _size = other._size;
+        _leaves = other._leaves;
+        _inners = other._inners;
+    }
+
+public:
+    BPlusTree() : _root(nullptr), _height(0), _size(0), _leaves(0), _inners(0), _first(nullptr) {}
+
+    ~BPlusTree() { clear(); }
+
+    BPlusTree(const BPlusTree<K, V>& other)
+        : _root(nullptr), _height(0), _size(0), _leaves(0), _inners(0), _first(nullptr) { copyFrom(other); }
+
+    BPlusTree<K, V>& operator=(const BPlusTree<K, V>& other) {
+        // check self-assignment
+        if (this == &other) return *this;
+
+        clear();
+        copyFrom(other);
+
+        return *this;
+    }
+
+    void put(K key, V value) {
+        // check first entry
+        if (!_root) {
+            leaf* l = new leaf();
+            insertAt(l, 0, key, value);
+            _root = _first = l;
+            _leaves = 1;
+            _size = 1;
+            return;
+        }
+
+        inner* path[BPLUS_MAX_HEIGHT];
+        int slots[BPLUS_MAX_HEIGHT];
+        void* temp = _root;
+
+        for (int depth = 0; depth < _height; depth++) {
+            path[depth] = static_cast<inner*>(temp);
+            slots[depth] = upperBound(path[depth]->keys, path[depth]->count, key);
+            temp = path[depth]->children[slots[depth]];
+        }
+
+        leaf* l = static_cast<leaf*>(temp);
+        int slot = lowerBound(l->keys, l->count, key);
+
+        // check duplicate keys
+        if (slot < l->count && l->keys[slot] == key) {
+            l->values[slot] = value;
+            return;
+        }
+
+        _size++;
+
+        if (l->count < LEAF_SLOTS) {
+            insertAt(l, slot, key, value);
+            return;
+        }
+
+        // the last leaf is on the right edge of every level above it, the first on the left edge
+        bool appending = slot == l->count && !l->next;
+        bool prepending = slot == 0 && l == _first;
+        void* child = splitLeaf(l, slot, key, value, appending, prepending);
+        K separator = static_cast<leaf*>(child)->keys[0];
+
+        // push the separator up until a node has room
+        for (int depth = _height - 1; depth >= 0; depth--) {
+            inner* parent = path[depth];
+
+            if (parent->count < INNER_SLOTS) {
+                insertAt(parent, slots[depth], separator, child);
+                return;
+            }
+
+            K promoted;
+            child = splitInner(parent, slots[depth], separator, child, appending, prepending, promoted);
+            separator = promoted;
+        }
+
+        // the root split: grow a level
+        inner* root = new inner();
+        _inners++;
+        root->keys[0] = separator;
+        root->children[0] = _root;
+        root->children[1] = child;
+        root->count = 1;
+        _root = root;
+        _height++;
+    }
+
+    V get(K key) const {
+        V* temp = findValue(key);
+
+        if (temp) return *temp;
+        else throw std::out_of_range("Key not found");
+    }
+
+    // non-throwing lookups: a miss costs the same as a hit
+    V* find(K key) { return findValue(key); }
+
+    const V* find(K key) const { return findValue(key); }
+
+    bool tryGet(K key, V& out) const {
+        V* temp = findValue(key);
+
+        if (!temp) return false;
+
+        out = *temp;
+        return true;
+    }
+
+    V getOrDefault(K key, V value) const {
+        V* temp = findValue(key);
+
+        return temp ? *temp : value;
+    }
+
+    bool contains(K key) const { return findValue(key) != nullptr; }
+
+    void remove(K key) {
+        if (!_root) throw std::out_of_range("Key not found");
+
+        inner* path[BPLUS_MAX_HEIGHT];
+        int slots[BPLUS_MAX_HEIGHT];
+        void* temp = _root;
+
+        for (int depth = 0; depth < _height; depth++) {
+            path[depth] = static_cast<inner*>(temp);
+            slots[depth] = upperBound(path[depth]->keys, path[depth]->count, key);
+            temp = path[depth]->children[slots[depth]];
+        }
+
+        leaf* l = static_cast<leaf*>(temp);
+        int slot = lowerBound(l->keys, l->count, key);
+
+        if (slot == l->count || !(l->keys[slot] == key)) throw std::out_of_range("Key not found");
+
+        for (int i = slot; i < l->count - 1; i++) {
+            l->keys[i] = l->keys[i + 1];
+            l->values[i] = l->values[i + 1];
+        }
+
+        l->count--;
+        _size--;
+
+        // in case of a root leaf
+        if (_height == 0) {
+            if (l->count == 0) clear();
+
+            return;
+        }
+
+        if (l->count >= LEAF_MIN) return;
+
+        bool merged = fixLeaf(path[_height - 1], slots[_height - 1]);
+
+        // a merge takes one key from the parent, which may underflow in turn
+        for (int depth = _height - 1; merged && depth > 0 && path[depth]->count < INNER_MIN; depth--) {
+            merged = fixInner(path[depth - 1], slots[depth - 1]);
+        }
+
+        // an empty root has a single child left: shrink a level
+        if (static_cast<inner*>(_root)->count == 0) {
+            inner* root = static_cast<inner*>(_root);
+            _root = root->children[0];
+            delete root;
+            _inners--;
+            _height--;
+        }
+    }
+
+    int size() const { return _size; }
+
+    bool isEmpty() const { return _size == 0; }
+
+    // nodes on every root-to-leaf path, 0 for an empty tree
+    int height() const { return _root ? _height + 1 : 0; }
+
+    // calls visit(key, value) once per entry, in ascending key order along the leaf chain
+    template<typename Visit>
+    void forEach(Visit visit) const {
+        for (const leaf* l = _first; l; l = l->next) {
+            for (int i = 0; i < l->count; i++) visit(l->keys[i], l->values[i]);
+        }
+    }
+
+    K min() const {
+        if (!_root) throw std::out_of_range("Tree is empty");
+
+        return _first->keys[0];
+    }
+
+    K max() const {
+        if (!_root) throw std::out_of_range("Tree is empty");
+
+        void* temp = _root;
+
+        for (int level = _height; level > 0; level--) {
+            inner* n = static_cast<inner*>(temp);
+            temp = n->children[n->count];
+        }
+
+        leaf* l = static_cast<leaf*>(temp);
+        return l->keys[l->count - 1];
+    }
+
+    // largest key <= key and smallest key >= key; nullptr when there is none. leaves are never
+    // empty, so when the answer is not in key's leaf it is at the near end of the neighbour
+    const K* floor(K key) const {
+        if (!_root) return nullptr;
+
+        leaf* l = findLeaf(key);
+        int slot = upperBound(l->keys, l->count, key) - 1;
+
+        if (slot >= 0) return &l->keys[slot];
+
+        return l->prev ? &l->prev->keys[l->prev->count - 1] : nullptr;
+    }
+
+    const K* ceiling(K key) const {
+        if (!_root) return nullptr;
+
+        leaf* l = findLeaf(key);
+        int slot = lowerBound(l->keys, l->count, key);
+
+        if (slot < l->count) return &l->keys[slot];
+
+        return l->next ? &l->next->keys[0] : nullptr;
+    }
+
+    // calls visit(key, value) for every key in [lo, hi], in order: one descent to lo, then a
+    // scan along the leaf chain
+    template<typename Visit>
+    void forEachInRange(K lo, K hi, Visit visit) const {
+        if (!_root) return;
+
+        const leaf* l = findLeaf(lo);
+        int slot = lowerBound(l->keys, l->count, lo);
+
+        for (; l; l = l->next, slot = 0) {
+            for (; slot < l->count; slot++) {
+                if (l->keys[slot] > hi) return;
+
+                visit(l->keys[slot], l->values[slot]);
+            }
+        }
+    }
+
+    // heap bytes held by the nodes, including their unused slots; memory owned by keys and
+    // values (e.g. string buffers) is not included
+    std::size_t memoryUsage() const {
+        return sizeof(*this) + sizeof(leaf) * _leaves + sizeof(inner) * _inners;
+    }
+
+    void clear() {
+        if (_root) cleanup(_root, _height);
+
+        _root = nullptr;
+        _first = nullptr;
+        _height = 0;
+        _size = 0;
+        _leaves = 0;
+        _inners = 0;
+    }
+};
+
+#endif
@@ -1,10 +1,23 @@
 #include "BST.h"
 #include <cassert>
 #include <string>
+#include <map>
+#include <vector>
+#include <iterator>
+#include <cmath>
 #include <iostream>
 
 
 constexpr int ELEMENTS {10'000};
+constexpr int BALANCED_ELEMENTS {100'000};
+
+
+// the textbook height limits: AVL < 1.44 log2(n + 2), red-black <= 2 log2(n + 1)
+bool heightWithinBound(BalanceMode mode, int height, int n) {
+    if (mode == BalanceMode::AVL) return height < 1.4405 * std::log2(n + 2.0);
+
+    return height <= 2.0 * std::log2(n + 1.0);
+}
 
 
 int main() {
@@ -312,6 +325,471 @@ int main() {
 
     std::cout << "Test 22 passed\n";
 
+    // Test 23: non-throwing lookups
+    BST<std::string, int> lookups;
+    lookups.put("m", 1);
+    lookups.put("c", 2);
+    lookups.put("x", 3);
+
+    assert(lookups.find("c") && *lookups.find("c") == 2);
+    assert(lookups.find("a") == nullptr);
+
+    *lookups.find("x") = 30;
+    assert(lookups.get("x") == 30);
+
+    int out {0};
+    assert(lookups.tryGet("m", out) && out == 1);
+    assert(!lookups.tryGet("z", out) && out == 1);
+
+    assert(lookups.getOrDefault("z", -1) == -1);
+    assert(lookups.getOrDefault("c", -1) == 2);
+
+    std::cout << "Test 23 passed\n";
+
+    // Test 24: balanced modes stay O(log n) high on sorted and reverse-sorted keys
+    const BalanceMode balanced[] {BalanceMode::RED_BLACK, BalanceMode::AVL};
+
+    for (BalanceMode mode : balanced) {
+        BST<int, int> ascending(mode);
+        BST<int, int> descending(mode);
+        assert(ascending.balanceMode() == mode);
+
+        for (int i = 0; i < BALANCED_ELEMENTS; i++) {
+            ascending.put(i, i);
+            descending.put(BALANCED_ELEMENTS - i, i);
+        }
+
+        assert(ascending.size() == BALANCED_ELEMENTS);
+        assert(heightWithinBound(mode, ascending.height(), ascending.size()));
+        assert(heightWithinBound(mode, descending.height(), descending.size()));
+
+        for (int i = 0; i < BALANCED_ELEMENTS; i++) {
+            assert(ascending.get(i) == i);
+            assert(descending.get(BALANCED_ELEMENTS - i) == i);
+        }
+
+        // removing every other key keeps the bound
+        for (int i = 0; i < BALANCED_ELEMENTS; i += 2) ascending.remove(i);
+
+        assert(ascending.size() == BALANCED_ELEMENTS / 2);
+        assert(heightWithinBound(mode, ascending.height(), ascending.size()));
+
+        for (int i = 0; i < BALANCED_ELEMENTS; i++) assert(ascending.contains(i) == (i % 2 == 1));
+    }
+
+    // the unbalanced tree is a linked list on the same input
+    BST<int, int> skewed;
+
+    for (int i = 0; i < 1000; i++) skewed.put(i, i);
+
+    assert(skewed.balanceMode() == BalanceMode::NONE);
+    assert(skewed.height() == 1000);
+
+    std::cout << "Test 24 passed\n";
+
+    // Test 25: random puts and removes in every mode, checked against std::map
+    const BalanceMode modes[] {BalanceMode::NONE, BalanceMode::RED_BLACK, BalanceMode::AVL};
+
+    for (BalanceMode mode : modes) {
+        BST<int, int> tree(mode);
+        std::map<int, int> reference;
+        unsigned int state {12345};
+
+        for (int i = 0; i < 20 * ELEMENTS; i++) {
+            state = state * 1103515245u + 12345u;
+            int key = static_cast<int>((state >> 8) % 2000);
+
+            if ((state >> 4) % 3 == 0) {
+                bool present = reference.erase(key) == 1;
+                bool thrown {false};
+
+                try {
+                    tree.remove(key);
+                } catch (const std::out_of_range&) {
+                    thrown = true;
+                }
+
+                assert(thrown == !present);
+            } else {
+                tree.put(key, i);
+                reference[key] = i;
+            }
+
+            if (i % 1000 == 0 && mode != BalanceMode::NONE) {
+                assert(heightWithinBound(mode, tree.height(), tree.size()));
+            }
+        }
+
+        assert(tree.size() == static_cast<int>(reference.size()));
+
+        for (int key = 0; key < 2000; key++) {
+            auto it = reference.find(key);
+            assert(tree.getOrDefault(key, -1) == (it == reference.end() ? -1 : it->second));
+        }
+
+        // drain completely, then the tree is reusable
+        for (const auto& p : reference) tree.remove(p.first);
+
+        assert(tree.isEmpty());
+        assert(tree.height() == 0);
+
+        tree.put(1, 1);
+        assert(tree.get(1) == 1 && tree.height() == 1);
+    }
+
+    std::cout << "Test 25 passed\n";
+
+    // Test 26: copies keep the mode and the shape, and are independent
+    BST<int, std::string> original(BalanceMode::RED_BLACK);
+
+    for (int i = 0; i < ELEMENTS; i++) original.put(i, std::to_string(i));
+
+    BST<int, std::string> copy(original);
+    assert(copy.balanceMode() == BalanceMode::RED_BLACK);
+    assert(copy.size() == ELEMENTS);
+    assert(copy.height() == original.height());
+
+    // the copy still balances: its own inserts and removes keep the bound
+    for (int i = ELEMENTS; i < 2 * ELEMENTS; i++) copy.put(i, std::to_string(i));
+
+    for (int i = 0; i < ELEMENTS; i += 3) copy.remove(i);
+
+    assert(heightWithinBound(BalanceMode::RED_BLACK, copy.height(), copy.size()));
+    assert(original.size() == ELEMENTS);
+    assert(original.get(3) == "3");
+    assert(!original.contains(ELEMENTS));
+
+    BST<int, std::string> assigned(BalanceMode::AVL);
+    assigned.put(-1, "gone");
+    assigned = copy;
+    assert(assigned.balanceMode() == BalanceMode::RED_BLACK);
+    assert(!assigned.contains(-1));
+    assert(assigned.size() == copy.size());
+    assert(assigned.height() == copy.height());
+
+    for (int i = 0; i < 2 * ELEMENTS; i++) assert(assigned.contains(i) == copy.contains(i));
+
+    BST<int, std::string> empty(BalanceMode::AVL);
+    assigned = empty;
+    assert(assigned.isEmpty());
+    assert(assigned.balanceMode() == BalanceMode::AVL);
+
+    std::cout << "Test 26 passed\n";
+
+    // Test 27: in-order iteration in every mode, forwards and backwards
+    for (BalanceMode mode : modes) {
+        BST<int, int> tree(mode);
+
+        assert(tree.begin() == tree.end());
+
+        for (int i = 0; i < ELEMENTS; i++) tree.put(static_cast<int>((i * 2654435761ULL) % ELEMENTS), i);
+
+        int expected {0};
+
+        for (auto entry : tree) {
+            assert(entry.key == expected);
+            expected++;
+        }
+
+        assert(expected == ELEMENTS);
+
+        // values are writable through a non-const tree
+        for (auto it = tree.begin(); it != tree.end(); ++it) it.value() = -it.key();
+
+        assert(tree.get(42) == -42);
+
+        const BST<int, int>& view = tree;
+        expected = ELEMENTS;
+
+        for (auto it = view.end(); it != view.begin();) {
+            --it;
+            expected--;
+            assert(it.key() == expected && (*it).value == -expected);
+        }
+
+        assert(expected == 0);
+
+        // removing other keys while walking keeps the iterator valid
+        for (auto it = tree.begin(); it != tree.end(); ++it) {
+            if (it.key() + 1 < ELEMENTS && it.key() % 2 == 0) tree.remove(it.key() + 1);
+        }
+
+        assert(tree.size() == ELEMENTS / 2);
+
+        BST<int, int>::const_iterator converted = tree.begin();
+        assert(converted.key() == 0);
+    }
+
+    std::cout << "Test 27 passed\n";
+
+    // Test 28: min, max, floor, ceiling, lowerBound, upperBound
+    BST<int, std::string> ordered(BalanceMode::AVL);
+
+    bool emptyThrown {false};
+    try {
+        ordered.min();
+    } catch (const std::out_of_range&) {
+        emptyThrown = true;
+    }
+    assert(emptyThrown);
+    assert(ordered.floor(5) == nullptr && ordered.ceiling(5) == nullptr);
+    assert(ordered.lowerBound(5) == ordered.end());
+
+    // multiples of 10 from 10 to 1000
+    for (int i = 100; i >= 1; i--) ordered.put(i * 10, std::to_string(i * 10));
+
+    assert(ordered.min() == 10 && ordered.max() == 1000);
+
+    assert(*ordered.floor(55) == 50);
+    assert(*ordered.floor(50) == 50);
+    assert(ordered.floor(9) == nullptr);
+    assert(*ordered.floor(5000) == 1000);
+
+    assert(*ordered.ceiling(55) == 60);
+    assert(*ordered.ceiling(60) == 60);
+    assert(ordered.ceiling(1001) == nullptr);
+    assert(*ordered.ceiling(-5) == 10);
+
+    assert(ordered.lowerBound(70).key() == 70);
+    assert(ordered.lowerBound(71).key() == 80);
+    assert(ordered.upperBound(70).key() == 80);
+    assert(ordered.upperBound(1000) == ordered.end());
+    assert(ordered.lowerBound(1000).value() == "1000");
+
+    std::cout << "Test 28 passed\n";
+
+    // Test 29: forEachInRange visits exactly the keys in [lo, hi], in order
+    int visits {0};
+    int previous {0};
+
+    ordered.forEachInRange(95, 305, [&visits, &previous](int key, const std::string& value) {
+        assert(key >= 95 && key <= 305 && key > previous);
+        assert(value == std::to_string(key));
+        previous = key;
+        visits++;
+    });
+    assert(visits == 21);
+
+    visits = 0;
+    ordered.forEachInRange(100, 100, [&visits](int, const std::string&) { visits++; });
+    assert(visits == 1);
+
+    visits = 0;
+    ordered.forEachInRange(300, 200, [&visits](int, const std::string&) { visits++; });
+    ordered.forEachInRange(1001, 2000, [&visits](int, const std::string&) { visits++; });
+    ordered.forEachInRange(-100, 9, [&visits](int, const std::string&) { visits++; });
+    assert(visits == 0);
+
+    ordered.forEachInRange(-100, 2000, [&visits](int, const std::string&) { visits++; });
+    assert(visits == ordered.size());
+
+    std::cout << "Test 29 passed\n";
+
+    // Test 30: rank, select and countInRange in every mode, through puts and removes
+    for (BalanceMode mode : modes) {
+        BST<int, int> tree(mode);
+        std::map<int, int> reference;
+        unsigned int state {777};
+
+        assert(tree.rank(5) == 0);
+        assert(tree.countInRange(0, 10) == 0);
+
+        bool rankThrown {false};
+        try {
+            tree.select(0);
+        } catch (const std::out_of_range&) {
+            rankThrown = true;
+        }
+        assert(rankThrown);
+
+        for (int i = 0; i < 10 * ELEMENTS; i++) {
+            state = state * 1103515245u + 12345u;
+            int key = static_cast<int>((state >> 8) % 5000);
+
+            if ((state >> 4) % 3 == 0) {
+                if (reference.erase(key)) tree.remove(key);
+            } else {
+                tree.put(key, i);
+                reference[key] = i;
+            }
+
+            // spot checks against the reference while the shape keeps changing
+            if (i % 5000 == 0 && !reference.empty()) {
+                int position {0};
+
+                for (const auto& p : reference) {
+                    if (position % 97 == 0) {
+                        assert(tree.select(position) == p.first);
+                        assert(tree.rank(p.first) == position);
+                    }
+
+                    position++;
+                }
+            }
+        }
+
+        // every key, present or not
+        int below {0};
+
+        for (int key = -1; key <= 5001; key++) {
+            assert(tree.rank(key) == below);
+
+            if (reference.count(key)) below++;
+        }
+
+        int position {0};
+
+        for (const auto& p : reference) assert(tree.select(position++) == p.first);
+
+        rankThrown = false;
+        try {
+            tree.select(tree.size());
+        } catch (const std::out_of_range&) {
+            rankThrown = true;
+        }
+        assert(rankThrown);
+
+        for (int lo = -10; lo < 5010; lo += 37) {
+            for (int width = 0; width < 3000; width += 611) {
+                int expected = static_cast<int>(std::distance(reference.lower_bound(lo), reference.upper_bound(lo + width)));
+                assert(tree.countInRange(lo, lo + width) == expected);
+            }
+        }
+
+        assert(tree.countInRange(10, 9) == 0);
+        assert(tree.countInRange(-1, 5000) == tree.size());
+
+        // copies carry the counts
+        BST<int, int> copy(tree);
+        assert(copy.select(copy.size() / 2) == tree.select(tree.size() / 2));
+        assert(copy.rank(2500) == tree.rank(2500));
+    }
+
+    // percentile of a sorted key set
+    BST<int, int> latencies(BalanceMode::RED_BLACK);
+
+    for (int i = 1; i <= 1000; i++) latencies.put(i, 0);
+
+    assert(latencies.select(latencies.size() * 99 / 100) == 991);
+    assert(latencies.rank(100) == 99);
+    assert(latencies.countInRange(100, 199) == 100);
+
+    std::cout << "Test 30 passed\n";
+
+    // Test 31: bulk build from a sorted range is perfectly balanced in every mode
+    std::vector<std::pair<int, int>> sortedInput;
+
+    for (int i = 0; i < BALANCED_ELEMENTS; i++) sortedInput.push_back({i * 2, i});
+
+    for (BalanceMode mode : modes) {
+        BST<int, int> bulk(sortedInput.begin(), sortedInput.end(), mode);
+        assert(bulk.balanceMode() == mode);
+        assert(bulk.size() == BALANCED_ELEMENTS);
+
+        // 100000 keys fill 17 levels
+        assert(bulk.height() == 17);
+
+        for (int i = 0; i < BALANCED_ELEMENTS; i++) assert(bulk.get(i * 2) == i);
+
+        assert(!bulk.contains(1));
+        assert(bulk.select(500) == 1000 && bulk.rank(1000) == 500);
+
+        // the built tree takes puts and removes like any other
+        for (int i = 0; i < BALANCED_ELEMENTS; i += 2) {
+            bulk.remove(i * 2);
+            bulk.put(i * 2 + 1, -i);
+        }
+
+        assert(bulk.size() == BALANCED_ELEMENTS);
+
+        if (mode != BalanceMode::NONE) assert(heightWithinBound(mode, bulk.height(), bulk.size()));
+
+        int previous {-1};
+
+        for (auto entry : bulk) {
+            assert(entry.key > previous);
+            previous = entry.key;
+        }
+    }
+
+    // empty and single-entry ranges
+    BST<int, int> none(sortedInput.begin(), sortedInput.begin(), BalanceMode::RED_BLACK);
+    assert(none.isEmpty() && none.height() == 0);
+
+    BST<int, int> one(sortedInput.begin(), sortedInput.begin() + 1, BalanceMode::RED_BLACK);
+    assert(one.size() == 1 && one.get(0) == 0);
+
+    std::cout << "Test 31 passed\n";
+
+    // Test 32: duplicates, unsorted input and assign
+    std::vector<std::pair<std::string, int>> withDuplicates {{"a", 1}, {"b", 2}, {"b", 3}, {"c", 4}, {"c", 5}, {"c", 6}};
+
+    BST<std::string, int> deduplicated(withDuplicates.begin(), withDuplicates.end(), BalanceMode::AVL);
+    assert(deduplicated.size() == 3);
+    assert(deduplicated.get("b") == 3 && deduplicated.get("c") == 6);
+
+    std::vector<std::pair<std::string, int>> unsorted {{"m", 1}, {"c", 2}, {"x", 3}, {"c", 4}, {"a", 5}, {"m", 6}};
+
+    bool unsortedThrown {false};
+    try {
+        BST<std::string, int> rejected(unsorted.begin(), unsorted.end());
+    } catch (const std::invalid_argument&) {
+        unsortedThrown = true;
+    }
+    assert(unsortedThrown);
+
+    // sorted = false sorts and deduplicates, the last of equal keys wins
+    BST<std::string, int> sortedFirst(unsorted.begin(), unsorted.end(), BalanceMode::RED_BLACK, false);
+    assert(sortedFirst.size() == 4);
+    assert(sortedFirst.get("c") == 4 && sortedFirst.get("m") == 6);
+    assert(sortedFirst.min() == "a" && sortedFirst.max() == "x");
+
+    // assign keeps the mode; a rejected range leaves the tree as it was
+    deduplicated.assign(unsorted.begin(), unsorted.end(), false);
+    assert(deduplicated.balanceMode() == BalanceMode::AVL);
+    assert(deduplicated.size() == 4 && deduplicated.get("x") == 3);
+    assert(!deduplicated.contains("b"));
+
+    unsortedThrown = false;
+    try {
+        deduplicated.assign(unsorted.begin(), unsorted.end());
+    } catch (const std::invalid_argument&) {
+        unsortedThrown = true;
+    }
+    assert(unsortedThrown);
+    assert(deduplicated.size() == 4 && deduplicated.get("a") == 5);
+
+    deduplicated.assign(unsorted.begin(), unsorted.begin());
+    assert(deduplicated.isEmpty());
+
+    // copies of a bulk-built tree
+    BST<std::string, int> copied(sortedFirst);
+    assert(copied.size() == 4 && copied.height() == sortedFirst.height());
+
+    std::cout << "Test 32 passed\n";
+
+    // Test 33: AVL removal of nodes with two children keeps the stored heights exact
+    for (int order = 0; order < 2; order++) {
+        BST<int, int> avl(BalanceMode::AVL);
+        unsigned int seed {7};
+
+        for (int i = 0; i < BALANCED_ELEMENTS / 5; i++) {
+            seed = seed * 1103515245u + 12345u;
+            avl.put(order == 0 ? i : static_cast<int>(seed >> 4), i);
+        }
+
+        while (avl.size() > 1) {
+            // the middle key is the root or next to it, so it has two children
+            avl.remove(avl.select(avl.size() / 2));
+
+            // height() reads the root's stored height; a stale one falls outside the possible range
+            assert(avl.height() >= std::ceil(std::log2(avl.size() + 1.0)));
+            assert(heightWithinBound(BalanceMode::AVL, avl.height(), avl.size()));
+        }
+    }
+
+    std::cout << "Test 33 passed\n";
+
     std::cout << "All tests passed successfully\n";
 
     return 0;
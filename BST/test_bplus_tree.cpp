@@ -0,0 +1,302 @@
+#include "bplus_tree.h"
+#include <cassert>
+#include <string>
+#include <map>
+#include <iostream>
+
+
+constexpr int ELEMENTS {100'000};
+
+
+int main() {
+    // Test 1: constructor
+    BPlusTree<std::string, int> tree;
+    assert(tree.isEmpty());
+    assert(tree.size() == 0);
+    assert(tree.height() == 0);
+    assert(!tree.contains("one"));
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: basic operations
+    tree.put("two", 2);
+    tree.put("one", 1);
+    tree.put("three", 3);
+    tree.put("one", 11);
+    assert(tree.size() == 3);
+    assert(tree.get("one") == 11);
+    assert(tree.contains("three"));
+    assert(!tree.contains("four"));
+    assert(tree.height() == 1);
+
+    tree.remove("two");
+    assert(!tree.contains("two"));
+    assert(tree.size() == 2);
+
+    bool thrown {false};
+    try {
+        tree.get("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        tree.remove("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    tree.remove("one");
+    tree.remove("three");
+    assert(tree.isEmpty());
+    assert(tree.height() == 0);
+
+    thrown = false;
+    try {
+        tree.remove("one");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: non-throwing lookups
+    BPlusTree<int, int> lookups;
+    lookups.put(5, 50);
+    lookups.put(1, 10);
+
+    assert(lookups.find(5) && *lookups.find(5) == 50);
+    assert(lookups.find(4) == nullptr);
+
+    *lookups.find(1) = 11;
+    assert(lookups.get(1) == 11);
+
+    int out {0};
+    assert(lookups.tryGet(5, out) && out == 50);
+    assert(!lookups.tryGet(6, out) && out == 50);
+    assert(lookups.getOrDefault(6, -1) == -1);
+    assert(lookups.getOrDefault(1, -1) == 11);
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: sorted, reverse-sorted and scrambled inserts split into several levels
+    BPlusTree<int, int> ascending;
+    BPlusTree<int, int> descending;
+    BPlusTree<int, int> scrambled;
+
+    for (int i = 0; i < ELEMENTS; i++) {
+        ascending.put(i, i);
+        descending.put(ELEMENTS - 1 - i, i);
+        scrambled.put(static_cast<int>((i * 2654435761ULL) % ELEMENTS), i);
+    }
+
+    assert(ascending.size() == ELEMENTS);
+    assert(descending.size() == ELEMENTS);
+    assert(scrambled.size() == ELEMENTS);
+    assert(ascending.height() > 2);
+
+    for (int i = 0; i < ELEMENTS; i++) {
+        assert(ascending.get(i) == i);
+        assert(descending.get(i) == ELEMENTS - 1 - i);
+        assert(scrambled.contains(i));
+    }
+
+    assert(!ascending.contains(-1));
+    assert(!ascending.contains(ELEMENTS));
+
+    // appends fill the leaves, so sorted input is no larger than scrambled input
+    assert(ascending.memoryUsage() <= scrambled.memoryUsage());
+    assert(descending.memoryUsage() <= scrambled.memoryUsage());
+
+    std::cout << "Test 4 passed\n";
+
+    // Test 5: forEach visits the entries in key order
+    int expected {0};
+    scrambled.forEach([&expected](int key, int) {
+        assert(key == expected);
+        expected++;
+    });
+    assert(expected == ELEMENTS);
+
+    std::cout << "Test 5 passed\n";
+
+    // Test 6: removes merge and refill nodes until the tree is empty again
+    for (int i = 0; i < ELEMENTS; i += 2) ascending.remove(i);
+
+    assert(ascending.size() == ELEMENTS / 2);
+
+    for (int i = 0; i < ELEMENTS; i++) assert(ascending.contains(i) == (i % 2 == 1));
+
+    for (int i = ELEMENTS - 1; i > 0; i -= 2) ascending.remove(i);
+
+    assert(ascending.isEmpty());
+    assert(ascending.height() == 0);
+    assert(!ascending.contains(1));
+
+    ascending.put(7, 7);
+    assert(ascending.get(7) == 7);
+
+    std::cout << "Test 6 passed\n";
+
+    // Test 7: random puts and removes, checked against std::map; string keys give narrow nodes
+    BPlusTree<std::string, int> random;
+    std::map<std::string, int> reference;
+    unsigned int state {12345};
+
+    for (int i = 0; i < 2 * ELEMENTS; i++) {
+        state = state * 1103515245u + 12345u;
+        std::string key = std::to_string((state >> 8) % 3000);
+
+        if ((state >> 4) % 5 < 2) {
+            bool present = reference.erase(key) == 1;
+
+            thrown = false;
+            try {
+                random.remove(key);
+            } catch (const std::out_of_range&) {
+                thrown = true;
+            }
+
+            assert(thrown == !present);
+        } else {
+            random.put(key, i);
+            reference[key] = i;
+        }
+    }
+
+    assert(random.size() == static_cast<int>(reference.size()));
+
+    auto it = reference.begin();
+    random.forEach([&it](const std::string& key, int value) {
+        assert(it->first == key && it->second == value);
+        ++it;
+    });
+    assert(it == reference.end());
+
+    for (const auto& p : reference) random.remove(p.first);
+
+    assert(random.isEmpty());
+
+    std::cout << "Test 7 passed\n";
+
+    // Test 8: copy constructor and assignment are deep
+    BPlusTree<int, std::string> original;
+
+    for (int i = 0; i < ELEMENTS / 10; i++) original.put(i, std::to_string(i));
+
+    BPlusTree<int, std::string> copy(original);
+    assert(copy.size() == original.size());
+    assert(copy.height() == original.height());
+    assert(copy.memoryUsage() == original.memoryUsage());
+
+    copy.put(-1, "new");
+    copy.remove(5);
+    assert(!original.contains(-1));
+    assert(original.get(5) == "5");
+
+    expected = -1;
+    copy.forEach([&expected](int key, const std::string&) {
+        if (expected == 5) expected++;
+        assert(key == expected);
+        expected++;
+    });
+
+    BPlusTree<int, std::string> assigned;
+    assigned.put(1 << 20, "gone");
+    assigned = copy;
+    assert(!assigned.contains(1 << 20));
+    assert(assigned.size() == copy.size());
+    assert(assigned.get(-1) == "new");
+
+    // self-assignment
+    assigned = assigned;
+    assert(assigned.size() == copy.size());
+
+    // empty assignment
+    BPlusTree<int, std::string> empty;
+    assigned = empty;
+    assert(assigned.isEmpty());
+
+    BPlusTree<int, std::string> emptyCopy(empty);
+    assert(emptyCopy.isEmpty());
+
+    std::cout << "Test 8 passed\n";
+
+    // Test 9: clear
+    original.clear();
+    assert(original.isEmpty());
+    assert(original.memoryUsage() == sizeof(original));
+    assert(!original.contains(0));
+
+    original.put(3, "3");
+    assert(original.size() == 1);
+
+    std::cout << "Test 9 passed\n";
+
+    // Test 10: min, max, floor, ceiling and forEachInRange, across leaf boundaries
+    BPlusTree<int, int> ordered;
+
+    thrown = false;
+    try {
+        ordered.max();
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(ordered.floor(1) == nullptr && ordered.ceiling(1) == nullptr);
+
+    for (int i = 1; i <= ELEMENTS; i++) ordered.put(i * 10, i);
+
+    // removes leave stale separators behind, which floor and ceiling have to see past
+    for (int i = 1; i <= ELEMENTS; i += 3) ordered.remove(i * 10);
+
+    assert(ordered.min() == 20 && ordered.max() == (ELEMENTS - 1) * 10);
+
+    for (int key = 3; key <= ELEMENTS * 10 + 10; key += 7) {
+        int below = key / 10;
+        int above = (key + 9) / 10;
+
+        while (below >= 1 && (below - 1) % 3 == 0) below--;
+        while (above <= ELEMENTS && (above - 1) % 3 == 0) above++;
+
+        const int* f = ordered.floor(key);
+        const int* c = ordered.ceiling(key);
+
+        assert(below >= 1 ? f && *f == below * 10 : !f);
+        assert(above <= ELEMENTS ? c && *c == above * 10 : !c);
+    }
+
+    int visits {0};
+    int previous {0};
+
+    ordered.forEachInRange(995, 30'005, [&visits, &previous](int key, int value) {
+        assert(key >= 995 && key <= 30'005 && key > previous);
+        assert(value == key / 10);
+        previous = key;
+        visits++;
+    });
+
+    int expectedVisits {0};
+
+    for (int i = 100; i <= 3000; i++) expectedVisits += (i - 1) % 3 != 0;
+
+    assert(visits == expectedVisits);
+
+    visits = 0;
+    ordered.forEachInRange(500, 400, [&visits](int, int) { visits++; });
+    ordered.forEachInRange(ELEMENTS * 10 + 1, ELEMENTS * 20, [&visits](int, int) { visits++; });
+    assert(visits == 0);
+
+    ordered.forEachInRange(0, ELEMENTS * 10, [&visits](int, int) { visits++; });
+    assert(visits == ordered.size());
+
+    std::cout << "Test 10 passed\n";
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "hash_table.h"
+#include <chrono>
+#include <string>
+#include <iostream>
+
+// both tables are far beyond any last-level cache
+const int intSize = 4'000'000;
+const int stringSize = 2'000'000;
+const int batchSize = 256;
+const int batches = 10'000;
+
+// loop of find vs getMany over the same random batches (about 10% misses); prints both timings
+template<typename K>
+void run(const char* label, const HashTable<K, int>& table, const K* keys) {
+    using namespace std::chrono;
+
+    const int* results[batchSize];
+    long long hitsSingle = 0, hitsBatch = 0;
+
+    auto start1 = high_resolution_clock::now();
+
+    for (int b = 0; b < batches; b++) {
+        for (int i = 0; i < batchSize; i++) hitsSingle += table.find(keys[b * batchSize + i]) != nullptr;
+    }
+
+    auto end1 = high_resolution_clock::now();
+    auto start2 = high_resolution_clock::now();
+
+    for (int b = 0; b < batches; b++) hitsBatch += table.getMany(keys + b * batchSize, batchSize, results);
+
+    auto end2 = high_resolution_clock::now();
+
+    if (hitsSingle != hitsBatch) std::cout << "hit mismatch\n";
+
+    double single = duration_cast<microseconds>(end1 - start1).count() / 1000.0;
+    double batch = duration_cast<microseconds>(end2 - start2).count() / 1000.0;
+
+    std::cout << label << " single find: " << single << " ms, getMany: " << batch << " ms, speedup: " << single / batch << "x\n";
+}
+
+int main() {
+    unsigned long long state = 42;
+
+    auto next = [&state](int bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>((state >> 33) % bound);
+    };
+
+    // Phase 1: int keys
+    HashTable<int, int> ints;
+
+    for (int i = 0; i < intSize; i++) ints.put(i, i);
+
+    int* intKeys = new int[batchSize * batches];
+
+    for (int i = 0; i < batchSize * batches; i++) intKeys[i] = next(intSize + intSize / 10);
+
+    run("int keys:   ", ints, intKeys);
+
+    delete[] intKeys;
+    ints.clear();
+
+    // Phase 2: string keys, each key compare touches another cache line
+    HashTable<std::string, int> strings;
+
+    for (int i = 0; i < stringSize; i++) strings.put("key:" + std::to_string(i * 7919LL) + ":payload", i);
+
+    std::string* stringKeys = new std::string[batchSize * batches];
+
+    for (int i = 0; i < batchSize * batches; i++) {
+        stringKeys[i] = "key:" + std::to_string(next(stringSize + stringSize / 10) * 7919LL) + ":payload";
+    }
+
+    run("string keys:", strings, stringKeys);
+
+    delete[] stringKeys;
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "hash_table.h"
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <iostream>
+
+const int size = 10'000'000;
+
+int main() {
+    using namespace std::chrono;
+
+    std::vector<std::pair<long long, long long>> pairs;
+    pairs.reserve(size);
+
+    // scrambled keys, so the input order says nothing about the bucket order
+    for (long long i = 0; i < size; i++) pairs.push_back({(i * 2654435761LL) % 1'000'000'007LL, i});
+
+    // Phase 1: loop of put, resizing as it grows
+    auto start1 = high_resolution_clock::now();
+
+    {
+        HashTable<long long, long long> table;
+
+        for (const auto& p : pairs) table.put(p.first, p.second);
+    }
+
+    auto end1 = high_resolution_clock::now();
+
+    // Phase 2: reserve, then put
+    auto start2 = high_resolution_clock::now();
+
+    {
+        HashTable<long long, long long> table;
+        table.reserve(size);
+
+        for (const auto& p : pairs) table.put(p.first, p.second);
+    }
+
+    auto end2 = high_resolution_clock::now();
+
+    std::cout << "put loop:            " << duration_cast<milliseconds>(end1 - start1).count() << " ms\n";
+    std::cout << "reserve + put:       " << duration_cast<milliseconds>(end2 - start2).count() << " ms\n";
+
+    // Phase 3: bulk constructor (timings include destruction, like the phases above)
+    int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+
+    for (int threads = 1; threads <= (maxThreads > 1 ? maxThreads : 1); threads *= 2) {
+        auto start3 = high_resolution_clock::now();
+
+        {
+            HashTable<long long, long long> table(pairs.begin(), pairs.end(), threads);
+        }
+
+        auto end3 = high_resolution_clock::now();
+
+        std::cout << "bulk, " << threads << " thread(s):    " << duration_cast<milliseconds>(end3 - start3).count() << " ms\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "concurrent_hash_table.h"
+#include "epoch_hash_table.h"
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <iostream>
+
+const int keys = 1'000'000;
+const int opsPerThread = 2'000'000;
+const int writePercent = 1;
+const int maxThreads = 32;
+
+// baseline: the whole table behind one global mutex
+struct GlobalLockTable {
+    std::mutex lock;
+    HashTable<int, int> table;
+
+    void put(int key, int value) {
+        std::lock_guard<std::mutex> guard(lock);
+        table.put(key, value);
+    }
+
+    bool containsKey(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.containsKey(key);
+    }
+};
+
+template<typename Table>
+double run(Table& table, int threads) {
+    using namespace std::chrono;
+
+    std::thread workers[maxThreads];
+    auto start = high_resolution_clock::now();
+
+    for (int t = 0; t < threads; t++) {
+        workers[t] = std::thread([&table, t]() {
+            // cheap per-thread LCG so key generation does not dominate
+            unsigned long long state = 0x9E3779B97F4A7C15ULL * (t + 1);
+            int hits = 0;
+
+            for (int i = 0; i < opsPerThread; i++) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                int key = static_cast<int>((state >> 33) % keys);
+
+                if (static_cast<int>((state >> 20) % 100) < writePercent) table.put(key, i);
+                else hits += table.containsKey(key);
+            }
+
+            if (hits < 0) std::cout << hits;
+        });
+    }
+
+    for (int t = 0; t < threads; t++) workers[t].join();
+
+    auto end = high_resolution_clock::now();
+    double seconds = duration_cast<microseconds>(end - start).count() / 1e6;
+
+    return threads * static_cast<double>(opsPerThread) / seconds / 1e6;
+}
+
+int main() {
+    GlobalLockTable global;
+    ConcurrentHashTable<int, int> sharded;
+    EpochHashTable<int, int> epoch;
+
+    for (int i = 0; i < keys; i++) {
+        global.table.put(i, i);
+        sharded.put(i, i);
+        epoch.put(i, i);
+    }
+
+    std::cout << "threads  global mutex (Mops/s)  sharded (Mops/s)  epoch (Mops/s)\n";
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double globalRate = run(global, threads);
+        double shardedRate = run(sharded, threads);
+        double epochRate = run(epoch, threads);
+
+        std::cout << threads << "        " << globalRate << "                " << shardedRate << "            " << epochRate << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "hash_table.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 10'000'000;
+
+int main() {
+    using namespace std::chrono;
+
+    HashTable<long long, long long> source;
+    source.reserve(size);
+
+    for (long long i = 0; i < size; i++) source.put((i * 2654435761LL) % 1'000'000'007LL, i);
+
+    // Phase 1: serial copy constructor
+    auto start1 = high_resolution_clock::now();
+    HashTable<long long, long long> serial(source);
+    auto end1 = high_resolution_clock::now();
+
+    std::cout << "copy constructor:      " << duration_cast<milliseconds>(end1 - start1).count() << " ms\n";
+
+    // Phase 2: parallel copy, timed without destruction
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        auto start2 = high_resolution_clock::now();
+        HashTable<long long, long long> cloned(source, threads);
+        auto end2 = high_resolution_clock::now();
+
+        std::cout << "parallel, " << threads << " thread(s):  " << duration_cast<milliseconds>(end2 - start2).count() << " ms\n";
+    }
+
+    // Phase 3: assignment into a table that already holds a copy
+    auto start3 = high_resolution_clock::now();
+    serial = source;
+    auto end3 = high_resolution_clock::now();
+
+    auto start4 = high_resolution_clock::now();
+    serial.assign(source, 4);
+    auto end4 = high_resolution_clock::now();
+
+    std::cout << "operator=:             " << duration_cast<milliseconds>(end3 - start3).count() << " ms\n";
+    std::cout << "assign, 4 threads:     " << duration_cast<milliseconds>(end4 - start4).count() << " ms\n";
+
+    return 0;
+}
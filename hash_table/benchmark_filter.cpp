@@ -0,0 +1,52 @@
+#include "hash_table.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 4'000'000;
+const int lookups = 10'000'000;
+
+// containsKey over keys that miss 90% of the time, with the given filter in front
+double run(HashTable<long long, int>& table, MembershipFilter type, const char* label) {
+    using namespace std::chrono;
+
+    table.setMembershipFilter(type);
+
+    long long hits {0};
+    unsigned long long state {7};
+
+    auto start = high_resolution_clock::now();
+
+    for (int i = 0; i < lookups; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        long long key = static_cast<long long>((state >> 33) % (size * 10LL));
+
+        hits += table.containsKey(key);
+    }
+
+    auto end = high_resolution_clock::now();
+    double ms = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    FilterStats stats = table.filterStats();
+
+    std::cout << label << ms << " ms (" << hits << " hits)";
+
+    if (type != MembershipFilter::NONE) {
+        std::cout << ", filter " << stats.bytes / 1024 << " KiB, estimated FP rate " << stats.falsePositiveRate * 100 << "%";
+    }
+
+    std::cout << "\n";
+
+    return ms;
+}
+
+int main() {
+    HashTable<long long, int> table;
+
+    for (int i = 0; i < size; i++) table.put(i, i);
+
+    run(table, MembershipFilter::NONE, "no filter:     ");
+    run(table, MembershipFilter::BLOOM, "Bloom filter:  ");
+    run(table, MembershipFilter::CUCKOO, "cuckoo filter: ");
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "hash_table.h"
+#include "fixed_hash_table.h"
+#include <chrono>
+#include <iostream>
+
+const int requests = 1'000'000;
+const int entries = 64;
+
+// one "request": build a scratch map, read it back, drop it
+template<typename Table>
+long long request(int seed) {
+    Table table;
+    long long sum {0};
+
+    for (int i = 0; i < entries; i++) table.put(seed + i * 7, i);
+
+    for (int i = 0; i < entries; i++) sum += table.getOrDefault(seed + i * 7, 0);
+
+    return sum;
+}
+
+template<typename Table>
+double run() {
+    using namespace std::chrono;
+
+    long long sum {0};
+    auto start = high_resolution_clock::now();
+
+    for (int r = 0; r < requests; r++) sum += request<Table>(r);
+
+    auto end = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    return duration_cast<microseconds>(end - start).count() / 1000.0;
+}
+
+int main() {
+    // sized so neither table resizes
+    struct Heap : HashTable<int, int> {
+        Heap() : HashTable<int, int>(128) {}
+    };
+
+    double heap = run<Heap>();
+    double fixed = run<FixedHashTable<int, int, entries>>();
+
+    std::cout << "HashTable(128):             " << heap << " ms\n";
+    std::cout << "FixedHashTable<int,int,64>: " << fixed << " ms\n";
+    std::cout << "Speedup: " << heap / fixed << "x\n";
+
+    return 0;
+}
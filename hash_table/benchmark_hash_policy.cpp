@@ -0,0 +1,102 @@
+#include "hash_table.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <iostream>
+
+const int sequentialKeys = 1'000'000;
+const int stridedKeys = 20'000;
+const int stringKeys = 1'000'000;
+
+// timing and bucket shape of one run
+struct run_stats {
+    double ms;
+    long long buckets;
+    long long occupied;
+    int longest;
+    // average nodes visited by a lookup that hits
+    double probes;
+};
+
+// insert every key, then look each one up; the chain statistics are taken after the timed part
+template<typename Table, typename Key>
+run_stats run(const Key* keys, int count) {
+    using namespace std::chrono;
+
+    auto start = high_resolution_clock::now();
+
+    Table table;
+    long long hits = 0;
+
+    for (int i = 0; i < count; i++) table.put(keys[i], i);
+    for (int i = 0; i < count; i++) hits += table.containsKey(keys[i]);
+
+    auto end = high_resolution_clock::now();
+
+    if (hits != count) std::cout << "lookup mismatch\n";
+
+    // no chain can be longer than count
+    long long* counts = new long long[count + 1];
+    table.chainHistogram(counts, count + 1);
+
+    run_stats stats {duration_cast<microseconds>(end - start).count() / 1000.0, 0, 0, 0, 0.0};
+    long long visits {0};
+
+    for (int length = 0; length <= count; length++) {
+        stats.buckets += counts[length];
+
+        if (length > 0) stats.occupied += counts[length];
+        if (counts[length] > 0) stats.longest = length;
+
+        // the i-th node of a chain is found after i steps
+        visits += counts[length] * length * (length + 1LL) / 2;
+    }
+
+    stats.probes = static_cast<double>(visits) / count;
+
+    delete[] counts;
+
+    return stats;
+}
+
+void print(const char* phase, const char* policy, const run_stats& stats) {
+    std::cout << phase << policy << stats.ms << " ms, " << stats.occupied << "/" << stats.buckets
+              << " buckets used, longest chain " << stats.longest << ", " << stats.probes << " nodes per hit\n";
+}
+
+int main() {
+    std::uint64_t* keys = new std::uint64_t[sequentialKeys];
+
+    // Phase 1: sequential integers
+    for (int i = 0; i < sequentialKeys; i++) keys[i] = i;
+
+    run_stats seqStd = run<HashTable<std::uint64_t, int, StdHash<std::uint64_t>>>(keys, sequentialKeys);
+    run_stats seqMix = run<HashTable<std::uint64_t, int>>(keys, sequentialKeys);
+
+    // Phase 2: adversarial integers, multiples of 2^20 share every low bit
+    for (int i = 0; i < stridedKeys; i++) keys[i] = static_cast<std::uint64_t>(i) << 20;
+
+    run_stats strideStd = run<HashTable<std::uint64_t, int, StdHash<std::uint64_t>>>(keys, stridedKeys);
+    run_stats strideMix = run<HashTable<std::uint64_t, int>>(keys, stridedKeys);
+
+    delete[] keys;
+
+    // Phase 3: strings
+    std::string* words = new std::string[stringKeys];
+
+    for (int i = 0; i < stringKeys; i++) words[i] = "user:" + std::to_string(i * 7919LL) + ":session";
+
+    run_stats strStd = run<HashTable<std::string, int, StdHash<std::string>>>(words, stringKeys);
+    run_stats strMix = run<HashTable<std::string, int>>(words, stringKeys);
+
+    delete[] words;
+
+    print("Phase 1 (1M sequential ints)  ", "std::hash:   ", seqStd);
+    print("                              ", "IntegerHash: ", seqMix);
+    print("Phase 2 (20K strided ints)    ", "std::hash:   ", strideStd);
+    print("                              ", "IntegerHash: ", strideMix);
+    print("Phase 3 (1M strings)          ", "std::hash:   ", strStd);
+    print("                              ", "StringHash:  ", strMix);
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "hash_table.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 1'000'000;
+const int lookups = 1'000'000;
+
+// the pre-change getOrDefault: every miss throws and unwinds
+int exceptionGetOrDefault(const HashTable<int, int>& table, int key, int value) {
+    try {
+        return table.get(key);
+    } catch (const std::out_of_range&) {
+        return value;
+    }
+}
+
+template<typename Lookup>
+double nsPerLookup(Lookup lookup, int offset) {
+    using namespace std::chrono;
+
+    long long sum = 0;
+    auto start = high_resolution_clock::now();
+
+    // keys >= size miss, keys < size hit
+    for (int i = 0; i < lookups; i++) sum += lookup(offset + i % size);
+
+    auto end = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    return duration_cast<nanoseconds>(end - start).count() / static_cast<double>(lookups);
+}
+
+int main() {
+    HashTable<int, int> table;
+
+    for (int i = 0; i < size; i++) table.put(i, i);
+
+    auto throwing = [&table](int key) { return exceptionGetOrDefault(table, key, -1); };
+    auto direct = [&table](int key) { return table.getOrDefault(key, -1); };
+    auto pointer = [&table](int key) { const int* v = table.find(key); return v ? *v : -1; };
+
+    std::cout << "                      hit (ns)   miss (ns)\n";
+    std::cout << "try/catch get         " << nsPerLookup(throwing, 0) << "    " << nsPerLookup(throwing, size) << "\n";
+    std::cout << "getOrDefault          " << nsPerLookup(direct, 0) << "    " << nsPerLookup(direct, size) << "\n";
+    std::cout << "find                  " << nsPerLookup(pointer, 0) << "    " << nsPerLookup(pointer, size) << "\n";
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "hash_table.h"
+#include "persistent_hash_map.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 1'000'000;
+const int lookups = 4'000'000;
+const int snapshots = 100;
+const int updatesPerSnapshot = 10'000;
+
+int main() {
+    using namespace std::chrono;
+
+    HashTable<int, int> table;
+    PersistentHashMap<int, int> map;
+
+    for (int i = 0; i < size; i++) {
+        table.put(i, i);
+        map.put(i, i);
+    }
+
+    // Phase 1: cost of one snapshot
+    auto start1 = high_resolution_clock::now();
+
+    for (int i = 0; i < 10; i++) {
+        HashTable<int, int> copy(table);
+
+        if (copy.size() != size) return 1;
+    }
+
+    auto end1 = high_resolution_clock::now();
+    auto start2 = high_resolution_clock::now();
+
+    for (int i = 0; i < 1000; i++) {
+        PersistentHashMap<int, int> copy = map.snapshot();
+
+        if (copy.size() != size) return 1;
+    }
+
+    auto end2 = high_resolution_clock::now();
+
+    std::cout << "snapshot, HashTable copy:     " << duration_cast<microseconds>(end1 - start1).count() / 10 << " us\n";
+    std::cout << "snapshot, PersistentHashMap:  " << duration_cast<nanoseconds>(end2 - start2).count() / 1000 << " ns\n";
+
+    // Phase 2: random lookups
+    unsigned long long state {1};
+    long long sum {0};
+
+    auto start3 = high_resolution_clock::now();
+
+    for (int i = 0; i < lookups; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        sum += table.get(static_cast<int>((state >> 33) % size));
+    }
+
+    auto end3 = high_resolution_clock::now();
+    auto start4 = high_resolution_clock::now();
+
+    for (int i = 0; i < lookups; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        sum += map.get(static_cast<int>((state >> 33) % size));
+    }
+
+    auto end4 = high_resolution_clock::now();
+
+    std::cout << "lookup, HashTable:            " << duration_cast<nanoseconds>(end3 - start3).count() / lookups << " ns\n";
+    std::cout << "lookup, PersistentHashMap:    " << duration_cast<nanoseconds>(end4 - start4).count() / lookups << " ns\n";
+
+    // Phase 3: a writer that publishes a snapshot every updatesPerSnapshot random updates
+    auto start5 = high_resolution_clock::now();
+
+    for (int s = 0; s < snapshots; s++) {
+        for (int i = 0; i < updatesPerSnapshot; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            table.put(static_cast<int>((state >> 33) % size), i);
+        }
+
+        HashTable<int, int> published(table);
+        sum += published.size();
+    }
+
+    auto end5 = high_resolution_clock::now();
+
+    PersistentHashMap<int, int> published;
+    auto start6 = high_resolution_clock::now();
+
+    for (int s = 0; s < snapshots; s++) {
+        for (int i = 0; i < updatesPerSnapshot; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            map.put(static_cast<int>((state >> 33) % size), i);
+        }
+
+        // the previous snapshot is still held here, so updates copy their paths
+        published = map.snapshot();
+        sum += published.size();
+    }
+
+    auto end6 = high_resolution_clock::now();
+
+    std::cout << "update + publish, HashTable:          " << duration_cast<milliseconds>(end5 - start5).count() << " ms\n";
+    std::cout << "update + publish, PersistentHashMap:  " << duration_cast<milliseconds>(end6 - start6).count() << " ms\n";
+
+    // Phase 4: updates with no snapshot alive change nodes in place
+    published.clear();
+    auto start7 = high_resolution_clock::now();
+
+    for (int i = 0; i < snapshots * updatesPerSnapshot; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        map.put(static_cast<int>((state >> 33) % size), i);
+    }
+
+    auto end7 = high_resolution_clock::now();
+
+    std::cout << "update, no snapshot, PersistentHashMap: "
+              << duration_cast<nanoseconds>(end7 - start7).count() / (snapshots * updatesPerSnapshot) << " ns\n";
+
+    if (sum == 42) std::cout << sum;
+
+    return 0;
+}
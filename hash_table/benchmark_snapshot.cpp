@@ -0,0 +1,50 @@
+#include "hash_table_snapshot.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+const int size = 10'000'000;
+const int lookups = 1'000'000;
+
+int main() {
+    using namespace std::chrono;
+
+    const std::string path {"benchmark_snapshot.bin"};
+
+    // Phase 1: build with put, the cost we pay at every start today
+    auto start1 = high_resolution_clock::now();
+
+    HashTable<long long, long long> table;
+
+    for (long long i = 0; i < size; i++) table.put(i * 7919, i);
+
+    auto end1 = high_resolution_clock::now();
+
+    saveSnapshot(table, path);
+    table.clear();
+
+    // Phase 2: open the snapshot
+    auto start2 = high_resolution_clock::now();
+
+    MappedHashTable<long long, long long> mapped(path);
+
+    auto end2 = high_resolution_clock::now();
+
+    // Phase 3: first lookups fault pages in from the page cache
+    long long sum {0};
+    auto start3 = high_resolution_clock::now();
+
+    for (long long i = 0; i < lookups; i++) sum += mapped.getOrDefault((i * 104729 % size) * 7919, 0);
+
+    auto end3 = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    std::cout << "Build with put:      " << duration_cast<milliseconds>(end1 - start1).count() << " ms\n";
+    std::cout << "Open snapshot:       " << duration_cast<microseconds>(end2 - start2).count() << " us\n";
+    std::cout << "1M mapped lookups:   " << duration_cast<milliseconds>(end3 - start3).count() << " ms\n";
+
+    std::remove(path.c_str());
+
+    return 0;
+}
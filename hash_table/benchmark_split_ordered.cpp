@@ -0,0 +1,79 @@
+#include "concurrent_hash_table.h"
+#include "epoch_hash_table.h"
+#include "split_ordered_hash_table.h"
+#include <chrono>
+#include <thread>
+#include <iostream>
+
+const int sharedKeys = 1'000'000;
+const int totalRounds = 2'000'000;
+const int window = 1024;
+const int maxThreads = 64;
+
+// one round is four operations: insert a key of the thread's own, remove the one it inserted
+// window rounds ago, update a shared key, look up a shared key
+template<typename Table>
+double run(Table& table, int threads) {
+    using namespace std::chrono;
+
+    std::thread workers[maxThreads];
+    int rounds = totalRounds / threads;
+    auto start = high_resolution_clock::now();
+
+    for (int t = 0; t < threads; t++) {
+        workers[t] = std::thread([&table, t, rounds]() {
+            // cheap per-thread LCG so key generation does not dominate
+            unsigned long long state = 0x9E3779B97F4A7C15ULL * (t + 1);
+            int own = (t + 1) << 24;
+            int hits = 0;
+
+            for (int i = 0; i < rounds; i++) {
+                table.put(own | i, i);
+
+                if (i >= window) table.remove(own | (i - window));
+
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                table.put(static_cast<int>((state >> 33) % sharedKeys), i);
+
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                hits += table.containsKey(static_cast<int>((state >> 33) % sharedKeys));
+            }
+
+            // leave only the shared keys for the next run
+            for (int i = rounds > window ? rounds - window : 0; i < rounds; i++) table.remove(own | i);
+
+            if (hits < 0) std::cout << hits;
+        });
+    }
+
+    for (int t = 0; t < threads; t++) workers[t].join();
+
+    auto end = high_resolution_clock::now();
+    double seconds = duration_cast<microseconds>(end - start).count() / 1e6;
+
+    return 4.0 * rounds * threads / seconds / 1e6;
+}
+
+int main() {
+    ConcurrentHashTable<int, int> sharded;
+    EpochHashTable<int, int> epoch;
+    SplitOrderedHashTable<int, int> splitOrdered;
+
+    for (int i = 0; i < sharedKeys; i++) {
+        sharded.put(i, i);
+        epoch.put(i, i);
+        splitOrdered.put(i, i);
+    }
+
+    std::cout << "threads  sharded (Mops/s)  epoch (Mops/s)  split-ordered (Mops/s)\n";
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double shardedRate = run(sharded, threads);
+        double epochRate = run(epoch, threads);
+        double splitRate = run(splitOrdered, threads);
+
+        std::cout << threads << "        " << shardedRate << "           " << epochRate << "         " << splitRate << "\n";
+    }
+
+    return 0;
+}
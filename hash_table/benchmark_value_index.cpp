@@ -0,0 +1,45 @@
+#include "hash_table.h"
+#include <chrono>
+#include <iostream>
+
+const int size = 1'000'000;
+const int distinctValues = 100'000;
+const int containsCalls = 100;
+
+// build, overwrite and shrink a table, then run containsValue; the index toggles the only difference
+void run(bool indexed) {
+    using namespace std::chrono;
+
+    HashTable<int, int> table;
+    table.setValueIndex(indexed);
+
+    auto start1 = high_resolution_clock::now();
+
+    for (int i = 0; i < size; i++) table.put(i, i % distinctValues);
+
+    for (int i = 0; i < size; i += 2) table.put(i, (i + 1) % distinctValues);
+
+    for (int i = 0; i < size; i += 4) table.remove(i);
+
+    auto end1 = high_resolution_clock::now();
+
+    int found {0};
+    auto start2 = high_resolution_clock::now();
+
+    // half of the probed values are absent, the expensive case for a scan
+    for (int i = 0; i < containsCalls; i++) found += table.containsValue(i % 2 ? i : -i - 1);
+
+    auto end2 = high_resolution_clock::now();
+
+    std::cout << (indexed ? "index on:  " : "index off: ")
+              << "put/overwrite/remove " << duration_cast<milliseconds>(end1 - start1).count() << " ms, "
+              << containsCalls << " containsValue " << duration_cast<microseconds>(end2 - start2).count() / 1000.0 << " ms"
+              << " (" << found << " found)\n";
+}
+
+int main() {
+    run(false);
+    run(true);
+
+    return 0;
+}
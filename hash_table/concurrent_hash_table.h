@@ -0,0 +1,157 @@
+#ifndef CONCURRENT_HASH_TABLE_H
+#define CONCURRENT_HASH_TABLE_H
+
+
+#include "hash_table.h"
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+
+static const int DEFAULT_SHARD_COUNT {64};
+
+
+template<typename K, typename V, typename Hash = DefaultHash<K>>
+class ConcurrentHashTable {
+private:
+    // one cache line per shard so neighbouring locks do not false-share
+    struct alignas(64) shard {
+        mutable std::shared_mutex lock;
+        HashTable<K, V, Hash> table;
+    };
+
+    shard* shards;
+    int _shardCount;
+    int shardBits;
+    Hash hasher;
+
+    // the shard comes from the high bits of the hash, the inner table masks the low ones
+    shard& shardFor(const K& key) const {
+        std::uint64_t h = hasher(key) * 0x9E3779B97F4A7C15ULL;
+
+        return shards[shardBits == 0 ? 0 : h >> (64 - shardBits)];
+    }
+
+    void copyFrom(const ConcurrentHashTable<K, V, Hash>& other) {
+        _shardCount = other._shardCount;
+        shardBits = other.shardBits;
+        shards = new shard[_shardCount];
+
+        for (int i = 0; i < _shardCount; i++) {
+            std::shared_lock<std::shared_mutex> guard(other.shards[i].lock);
+            shards[i].table = other.shards[i].table;
+        }
+    }
+
+public:
+    ConcurrentHashTable(int s = DEFAULT_SHARD_COUNT, int c = DEFAULT_CAPACITY) : shardBits(0) {
+        if (s < 1) throw std::invalid_argument("Shard count must be at least 1");
+        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
+
+        // round up to a power of two
+        while ((1 << shardBits) < s) shardBits++;
+
+        _shardCount = 1 << shardBits;
+        shards = new shard[_shardCount];
+
+        if (c != DEFAULT_CAPACITY) {
+            for (int i = 0; i < _shardCount; i++) shards[i].table.clear(c);
+        }
+    }
+
+    ~ConcurrentHashTable() { delete[] shards; }
+
+    ConcurrentHashTable(const ConcurrentHashTable<K, V, Hash>& other) { copyFrom(other); }
+
+    // not safe against concurrent use of *this, like every assignment
+    ConcurrentHashTable<K, V, Hash>& operator=(const ConcurrentHashTable<K, V, Hash>& other) {
+        // check self-assignment
+        if (this == &other) return *this;
+
+        delete[] shards;
+        copyFrom(other);
+
+        return *this;
+    }
+
+    void put(const K& key, const V& value) {
+        shard& s = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(s.lock);
+
+        s.table.put(key, value);
+    }
+
+    V get(const K& key) const {
+        shard& s = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+
+        return s.table.get(key);
+    }
+
+    V getOrDefault(const K& key, const V& value) const {
+        shard& s = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+
+        return s.table.getOrDefault(key, value);
+    }
+
+    // copies the value out under the shard lock; a pointer would outlive it
+    bool tryGet(const K& key, V& out) const {
+        shard& s = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+
+        return s.table.tryGet(key, out);
+    }
+
+    void remove(const K& key) {
+        shard& s = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(s.lock);
+
+        s.table.remove(key);
+    }
+
+    bool containsKey(const K& key) const {
+        shard& s = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+
+        return s.table.containsKey(key);
+    }
+
+    // locks one shard at a time, so the answer is not a global snapshot
+    bool containsValue(const V& value) const {
+        for (int i = 0; i < _shardCount; i++) {
+            std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+
+            if (shards[i].table.containsValue(value)) return true;
+        }
+
+        return false;
+    }
+
+    // sum of per-shard sizes, exact only when no writer is active
+    int size() const {
+        int total {0};
+
+        for (int i = 0; i < _shardCount; i++) {
+            std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+            total += shards[i].table.size();
+        }
+
+        return total;
+    }
+
+    bool isEmpty() const { return size() == 0; }
+
+    int shardCount() const { return _shardCount; }
+
+    void clear(int c = DEFAULT_CAPACITY) {
+        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
+
+        for (int i = 0; i < _shardCount; i++) {
+            std::unique_lock<std::shared_mutex> guard(shards[i].lock);
+            shards[i].table.clear(c);
+        }
+    }
+};
+
+#endif
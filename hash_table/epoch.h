@@ -0,0 +1,200 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+
+#include <atomic>
+#include <stdexcept>
+#include <cstdint>
+
+
+static const int MAX_EPOCH_THREADS {128};
+static const int EPOCH_ADVANCE_INTERVAL {64};
+
+
+// global registry of thread slots shared by every EpochManager
+class EpochSlots {
+private:
+    static std::atomic<bool>* used() {
+        static std::atomic<bool> slots[MAX_EPOCH_THREADS] {};
+        return slots;
+    }
+
+    // releases the slot when the owning thread exits
+    struct owner {
+        int slot;
+
+        owner() : slot(-1) {
+            for (int i = 0; i < MAX_EPOCH_THREADS; i++) {
+                bool expected {false};
+
+                if (used()[i].compare_exchange_strong(expected, true)) {
+                    slot = i;
+                    return;
+                }
+            }
+        }
+
+        ~owner() { if (slot >= 0) used()[slot].store(false); }
+    };
+
+public:
+    static int current() {
+        // plain thread_local int keeps the hot path free of the TLS init guard
+        static thread_local int cached {-1};
+
+        if (cached >= 0) return cached;
+
+        static thread_local owner self;
+
+        if (self.slot < 0) throw std::runtime_error("Too many threads for epoch reclamation");
+
+        cached = self.slot;
+        return cached;
+    }
+};
+
+
+// epoch-based reclamation: memory retired in epoch e is freed once the global epoch reaches e + 2,
+// which proves that no reader pinned at e or earlier can still hold a reference to it
+class EpochManager {
+private:
+    struct retired {
+        void* ptr;
+        void (*deleter)(void*);
+        retired* next;
+    };
+
+    // per-thread state, a cache line each; only the owning thread writes to it
+    struct alignas(64) slot {
+        // 0 when outside a critical section, otherwise (epoch << 1) | 1
+        std::atomic<std::uint64_t> local;
+        std::uint64_t lastEpoch;
+        int depth;
+        int retiredSinceAdvance;
+        retired* limbo[3];
+    };
+
+    alignas(64) std::atomic<std::uint64_t> globalEpoch;
+    slot* slots;
+
+    static void freeList(retired* list) {
+        while (list) {
+            retired* temp = list;
+            list = list->next;
+            temp->deleter(temp->ptr);
+            delete temp;
+        }
+    }
+
+    // advance the global epoch if every pinned thread has observed the current one
+    void tryAdvance() {
+        std::uint64_t epoch = globalEpoch.load(std::memory_order_seq_cst);
+
+        for (int i = 0; i < MAX_EPOCH_THREADS; i++) {
+            std::uint64_t local = slots[i].local.load(std::memory_order_seq_cst);
+
+            if ((local & 1) && (local >> 1) != epoch) return;
+        }
+
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+public:
+    EpochManager() : globalEpoch(0) {
+        slots = new slot[MAX_EPOCH_THREADS];
+
+        for (int i = 0; i < MAX_EPOCH_THREADS; i++) {
+            slots[i].local.store(0, std::memory_order_relaxed);
+            slots[i].lastEpoch = 0;
+            slots[i].depth = 0;
+            slots[i].retiredSinceAdvance = 0;
+            slots[i].limbo[0] = slots[i].limbo[1] = slots[i].limbo[2] = nullptr;
+        }
+    }
+
+    // callers guarantee that no thread is still inside a critical section
+    ~EpochManager() {
+        for (int i = 0; i < MAX_EPOCH_THREADS; i++) {
+            for (int j = 0; j < 3; j++) freeList(slots[i].limbo[j]);
+        }
+
+        delete[] slots;
+    }
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    // enter a read-side critical section: one load and one store, no read-modify-write;
+    // returns the caller's slot so unpin can skip the thread lookup
+    int pin() {
+        int index = EpochSlots::current();
+        slot& s = slots[index];
+
+        if (s.depth++ > 0) return index;
+
+        // publish, then re-read until the global epoch is unchanged. a thread preempted between the
+        // load and the store would otherwise pin at e after others reached e + 2 and file what it
+        // unlinks under an epoch they have already left behind. once the value is stable, the
+        // global epoch can advance at most once while this thread stays pinned
+        std::uint64_t epoch = globalEpoch.load(std::memory_order_seq_cst);
+
+        for (;;) {
+            s.local.store((epoch << 1) | 1, std::memory_order_seq_cst);
+
+            std::uint64_t current = globalEpoch.load(std::memory_order_seq_cst);
+
+            if (current == epoch) break;
+
+            epoch = current;
+        }
+
+        // entering a new epoch e: everything this thread retired at e - 3 or earlier is unreachable
+        if (epoch != s.lastEpoch) {
+            retired* list = s.limbo[epoch % 3];
+            s.limbo[epoch % 3] = nullptr;
+            s.lastEpoch = epoch;
+            freeList(list);
+        }
+
+        return index;
+    }
+
+    void unpin(int index) {
+        slot& s = slots[index];
+
+        if (--s.depth == 0) s.local.store(0, std::memory_order_release);
+    }
+
+    // hand over memory that was unlinked inside the current critical section
+    template<typename T>
+    void retire(T* ptr) {
+        slot& s = slots[EpochSlots::current()];
+        retired* r = new retired {ptr, [](void* p) { delete static_cast<T*>(p); }, nullptr};
+
+        r->next = s.limbo[s.lastEpoch % 3];
+        s.limbo[s.lastEpoch % 3] = r;
+
+        if (++s.retiredSinceAdvance >= EPOCH_ADVANCE_INTERVAL) {
+            s.retiredSinceAdvance = 0;
+            tryAdvance();
+        }
+    }
+};
+
+
+// RAII critical section
+class EpochGuard {
+private:
+    EpochManager& manager;
+    int slot;
+
+public:
+    explicit EpochGuard(EpochManager& m) : manager(m), slot(m.pin()) {}
+
+    ~EpochGuard() { manager.unpin(slot); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef EPOCH_HASH_TABLE_H
+#define EPOCH_HASH_TABLE_H
+
+
+#include "epoch.h"
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <functional>
+
+
+static const int EPOCH_DEFAULT_CAPACITY {16};
+static const float EPOCH_MIN_LF {0.25f};
+static const float EPOCH_MAX_LF {0.75f};
+
+
+// nodes are immutable once published; an update replaces the whole node
+template<typename K, typename V>
+struct epoch_node {
+    const K key;
+    const V value;
+    std::atomic<epoch_node*> next;
+
+    epoch_node(const K& k, const V& v, epoch_node* n) : key(k), value(v), next(n) {}
+};
+
+
+// a bucket array owns its chains, so retiring it after a resize frees every copied-away node
+template<typename K, typename V>
+struct epoch_table {
+    int capacity;
+    std::atomic<epoch_node<K, V>*>* buckets;
+
+    epoch_table(int c) : capacity(c), buckets(new std::atomic<epoch_node<K, V>*>[c]) {
+        for (int i = 0; i < capacity; i++) buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~epoch_table() {
+        epoch_node<K, V>* temp1;
+        epoch_node<K, V>* temp2;
+
+        for (int i = 0; i < capacity; i++) {
+            temp1 = buckets[i].load(std::memory_order_relaxed);
+
+            while (temp1) {
+                temp2 = temp1;
+                temp1 = temp1->next.load(std::memory_order_relaxed);
+                delete temp2;
+            }
+        }
+
+        delete[] buckets;
+    }
+};
+
+
+// readers never lock: they pin an epoch and follow acquire loads;
+// writers serialize on one mutex, publish with release stores and retire what they unlink
+template<typename K, typename V>
+class EpochHashTable {
+private:
+    std::atomic<epoch_table<K, V>*> current;
+    std::atomic<int> _size;
+    std::mutex writeLock;
+    mutable EpochManager epochs;
+
+    static std::size_t hash(const K& key, int c) {
+        std::hash<K> hasher;
+
+        return hasher(key) % c;
+    }
+
+    const epoch_node<K, V>* find(const K& key) const {
+        epoch_table<K, V>* t = current.load(std::memory_order_acquire);
+        epoch_node<K, V>* temp = t->buckets[hash(key, t->capacity)].load(std::memory_order_acquire);
+
+        while (temp) {
+            if (temp->key == key) return temp;
+
+            temp = temp->next.load(std::memory_order_acquire);
+        }
+
+        return nullptr;
+    }
+
+    // copy every node into a fresh array; relinking in place would strand concurrent readers
+    void resize(int newCapacity) {
+        epoch_table<K, V>* oldTable = current.load(std::memory_order_relaxed);
+        epoch_table<K, V>* newTable = new epoch_table<K, V>(newCapacity);
+
+        for (int i = 0; i < oldTable->capacity; i++) {
+            epoch_node<K, V>* temp = oldTable->buckets[i].load(std::memory_order_relaxed);
+
+            while (temp) {
+                std::atomic<epoch_node<K, V>*>& head = newTable->buckets[hash(temp->key, newCapacity)];
+                head.store(new epoch_node<K, V>(temp->key, temp->value, head.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+
+                temp = temp->next.load(std::memory_order_relaxed);
+            }
+        }
+
+        current.store(newTable, std::memory_order_release);
+        epochs.retire(oldTable);
+    }
+
+public:
+    EpochHashTable(int c = EPOCH_DEFAULT_CAPACITY) : _size(0) {
+        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
+
+        current.store(new epoch_table<K, V>(c), std::memory_order_relaxed);
+    }
+
+    // callers guarantee that no other thread still uses the table
+    ~EpochHashTable() { delete current.load(std::memory_order_relaxed); }
+
+    // shared between threads by reference, never copied
+    EpochHashTable(const EpochHashTable<K, V>&) = delete;
+    EpochHashTable<K, V>& operator=(const EpochHashTable<K, V>&) = delete;
+
+    void put(const K& key, const V& value) {
+        std::lock_guard<std::mutex> lock(writeLock);
+        EpochGuard guard(epochs);
+
+        epoch_table<K, V>* t = current.load(std::memory_order_relaxed);
+
+        if (static_cast<double>(_size.load(std::memory_order_relaxed)) / t->capacity > EPOCH_MAX_LF) {
+            resize(t->capacity * 2);
+            t = current.load(std::memory_order_relaxed);
+        }
+
+        std::atomic<epoch_node<K, V>*>* link = &t->buckets[hash(key, t->capacity)];
+        epoch_node<K, V>* temp;
+
+        while ((temp = link->load(std::memory_order_relaxed))) {
+            if (temp->key == key) {
+                // swap in a replacement so readers see either the old or the new value, never a torn one
+                link->store(new epoch_node<K, V>(key, value, temp->next.load(std::memory_order_relaxed)), std::memory_order_release);
+                epochs.retire(temp);
+                return;
+            }
+
+            link = &temp->next;
+        }
+
+        std::atomic<epoch_node<K, V>*>& head = t->buckets[hash(key, t->capacity)];
+        head.store(new epoch_node<K, V>(key, value, head.load(std::memory_order_relaxed)), std::memory_order_release);
+
+        _size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    V get(const K& key) const {
+        EpochGuard guard(epochs);
+
+        const epoch_node<K, V>* temp = find(key);
+
+        if (!temp) throw std::out_of_range("Key not found");
+
+        return temp->value;
+    }
+
+    V getOrDefault(const K& key, const V& value) const {
+        EpochGuard guard(epochs);
+
+        const epoch_node<K, V>* temp = find(key);
+
+        return temp ? temp->value : value;
+    }
+
+    void remove(const K& key) {
+        std::lock_guard<std::mutex> lock(writeLock);
+        EpochGuard guard(epochs);
+
+        epoch_table<K, V>* t = current.load(std::memory_order_relaxed);
+        std::atomic<epoch_node<K, V>*>* link = &t->buckets[hash(key, t->capacity)];
+        epoch_node<K, V>* temp;
+
+        while ((temp = link->load(std::memory_order_relaxed))) {
+            if (temp->key == key) {
+                // readers already on temp still reach the rest of the chain through temp->next
+                link->store(temp->next.load(std::memory_order_relaxed), std::memory_order_release);
+                epochs.retire(temp);
+
+                int newSize = _size.fetch_sub(1, std::memory_order_relaxed) - 1;
+
+                if (t->capacity > EPOCH_DEFAULT_CAPACITY && static_cast<double>(newSize) / t->capacity < EPOCH_MIN_LF) {
+                    resize(t->capacity / 2);
+                }
+
+                return;
+            }
+
+            link = &temp->next;
+        }
+
+        throw std::out_of_range("Key not found");
+    }
+
+    bool containsKey(const K& key) const {
+        EpochGuard guard(epochs);
+
+        return find(key) != nullptr;
+    }
+
+    int size() const { return _size.load(std::memory_order_relaxed); }
+
+    bool isEmpty() const { return size() == 0; }
+
+    void clear(int c = EPOCH_DEFAULT_CAPACITY) {
+        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
+
+        std::lock_guard<std::mutex> lock(writeLock);
+        EpochGuard guard(epochs);
+
+        epoch_table<K, V>* oldTable = current.load(std::memory_order_relaxed);
+
+        current.store(new epoch_table<K, V>(c), std::memory_order_release);
+        _size.store(0, std::memory_order_relaxed);
+        epochs.retire(oldTable);
+    }
+};
+
+#endif
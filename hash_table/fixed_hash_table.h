@@ -0,0 +1,235 @@
+#ifndef FIXED_HASH_TABLE_H
+#define FIXED_HASH_TABLE_H
+
+
+#include "hash_policy.h"
+#include <stdexcept>
+#include <new>
+#include <cstddef>
+
+
+// smallest power of two >= n, usable in constant expressions
+constexpr int fixedBucketCount(int n) {
+    int rounded {1};
+
+    while (rounded < n) rounded *= 2;
+
+    return rounded;
+}
+
+
+// chained hash table with room for exactly N entries, all stored inline: no heap allocation
+// ever, so it can live on the stack. chains link slots by index (0 ends a chain, slot i is
+// stored as i + 1), which keeps a zeroed object empty and the links valid after a copy
+template<typename K, typename V, int N, typename Hash = DefaultHash<K>>
+class FixedHashTable {
+    static_assert(N > 0, "Capacity must be positive");
+
+private:
+    struct entry {
+        K key;
+        V value;
+
+        entry(const K& k, const V& v) : key(k), value(v) {}
+    };
+
+    static constexpr int BUCKETS {fixedBucketCount(N)};
+    static constexpr std::size_t MASK {BUCKETS - 1};
+
+    int heads[BUCKETS];
+    // chain link of a live slot, free-list link of a released one
+    int links[N];
+    std::size_t hashes[N];
+    alignas(entry) unsigned char storage[N][sizeof(entry)];
+
+    int _size;
+    // slots [used, N) have never been handed out
+    int used;
+    int freeList;
+
+    Hash hasher;
+
+    entry& at(int slot) { return *std::launder(reinterpret_cast<entry*>(storage[slot])); }
+    const entry& at(int slot) const { return *std::launder(reinterpret_cast<const entry*>(storage[slot])); }
+
+    // slot of key, or -1
+    int findSlot(const K& key, std::size_t h) const {
+        for (int link = heads[h & MASK]; link; link = links[link - 1]) {
+            if (hashes[link - 1] == h && at(link - 1).key == key) return link - 1;
+        }
+
+        return -1;
+    }
+
+    int findSlot(const K& key) const { return findSlot(key, hasher(key)); }
+
+    void destroyAll() {
+        for (int b = 0; b < BUCKETS; b++) {
+            for (int link = heads[b]; link; link = links[link - 1]) at(link - 1).~entry();
+        }
+    }
+
+    void reset() {
+        for (int b = 0; b < BUCKETS; b++) heads[b] = 0;
+
+        _size = 0;
+        used = 0;
+        freeList = 0;
+    }
+
+    // same hash, so every entry keeps its slot and every link stays valid
+    void copyFrom(const FixedHashTable<K, V, N, Hash>& other) {
+        for (int b = 0; b < BUCKETS; b++) heads[b] = other.heads[b];
+
+        for (int i = 0; i < other.used; i++) {
+            links[i] = other.links[i];
+            hashes[i] = other.hashes[i];
+        }
+
+        for (int b = 0; b < BUCKETS; b++) {
+            for (int link = heads[b]; link; link = links[link - 1]) {
+                new (storage[link - 1]) entry(other.at(link - 1).key, other.at(link - 1).value);
+            }
+        }
+
+        _size = other._size;
+        used = other.used;
+        freeList = other.freeList;
+    }
+
+public:
+    FixedHashTable() { reset(); }
+
+    ~FixedHashTable() { destroyAll(); }
+
+    FixedHashTable(const FixedHashTable<K, V, N, Hash>& other) { copyFrom(other); }
+
+    FixedHashTable<K, V, N, Hash>& operator=(const FixedHashTable<K, V, N, Hash>& other) {
+        // check self-assignment
+        if (this == &other) return *this;
+
+        destroyAll();
+        copyFrom(other);
+
+        return *this;
+    }
+
+    // returns false, changing nothing, when key is new and all N slots are taken
+    bool put(const K& key, const V& value) {
+        std::size_t h = hasher(key);
+        int slot = findSlot(key, h);
+
+        if (slot >= 0) {
+            at(slot).value = value;
+            return true;
+        }
+
+        if (freeList) {
+            slot = freeList - 1;
+            freeList = links[slot];
+        } else if (used < N) {
+            slot = used++;
+        } else {
+            return false;
+        }
+
+        try {
+            new (storage[slot]) entry(key, value);
+        } catch (...) {
+            links[slot] = freeList;
+            freeList = slot + 1;
+            throw;
+        }
+
+        hashes[slot] = h;
+        links[slot] = heads[h & MASK];
+        heads[h & MASK] = slot + 1;
+
+        _size++;
+        return true;
+    }
+
+    const V& get(const K& key) const {
+        int slot = findSlot(key);
+
+        if (slot < 0) throw std::out_of_range("Key not found");
+
+        return at(slot).value;
+    }
+
+    V* find(const K& key) {
+        int slot = findSlot(key);
+
+        return slot < 0 ? nullptr : &at(slot).value;
+    }
+
+    const V* find(const K& key) const {
+        int slot = findSlot(key);
+
+        return slot < 0 ? nullptr : &at(slot).value;
+    }
+
+    bool tryGet(const K& key, V& out) const {
+        int slot = findSlot(key);
+
+        if (slot < 0) return false;
+
+        out = at(slot).value;
+        return true;
+    }
+
+    V getOrDefault(const K& key, const V& value) const {
+        int slot = findSlot(key);
+
+        return slot < 0 ? value : at(slot).value;
+    }
+
+    void remove(const K& key) {
+        std::size_t h = hasher(key);
+
+        // walk the links themselves so the first entry needs no special case
+        for (int* link = &heads[h & MASK]; *link; link = &links[*link - 1]) {
+            int slot = *link - 1;
+
+            if (hashes[slot] == h && at(slot).key == key) {
+                *link = links[slot];
+                at(slot).~entry();
+
+                links[slot] = freeList;
+                freeList = slot + 1;
+
+                _size--;
+                return;
+            }
+        }
+
+        throw std::out_of_range("Key not found");
+    }
+
+    bool containsKey(const K& key) const { return findSlot(key) >= 0; }
+
+    bool containsValue(const V& value) const {
+        for (int b = 0; b < BUCKETS; b++) {
+            for (int link = heads[b]; link; link = links[link - 1]) {
+                if (at(link - 1).value == value) return true;
+            }
+        }
+
+        return false;
+    }
+
+    int size() const { return _size; }
+
+    bool isEmpty() const { return _size == 0; }
+
+    bool isFull() const { return _size == N; }
+
+    static constexpr int capacity() { return N; }
+
+    void clear() {
+        destroyAll();
+        reset();
+    }
+};
+
+#endif
@@ -0,0 +1,354 @@
+#ifndef FLAT_HASH_TABLE_H
+#define FLAT_HASH_TABLE_H
+
+
+#include "hash_policy.h"
+#include <stdexcept>
+#include <new>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLAT_HASH_TABLE_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+static const int FLAT_DEFAULT_CAPACITY {16};
+static const int FLAT_GROUP_WIDTH {16};
+static const float FLAT_MIN_LF {0.25f};
+static const float FLAT_MAX_LF {0.875f};
+
+// control byte states: a full slot stores the low 7 bits of its hash (0..127)
+static const std::int8_t CTRL_EMPTY {-128};
+static const std::int8_t CTRL_DELETED {-2};
+
+
+template<typename K, typename V>
+struct flat_slot {
+    K key;
+    V value;
+
+    flat_slot(const K& k, const V& v) : key(k), value(v) {}
+
+    flat_slot(K&& k, V&& v) : key(std::move(k)), value(std::move(v)) {}
+};
+
+
+// bitmask of matching positions inside one group of 16 control bytes
+class GroupMask {
+private:
+    std::uint32_t mask;
+
+public:
+    explicit GroupMask(std::uint32_t m) : mask(m) {}
+
+    bool any() const { return mask != 0; }
+
+    int lowest() const {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    void next() { mask &= mask - 1; }
+};
+
+
+class Group {
+private:
+#ifdef FLAT_HASH_TABLE_SSE2
+    __m128i ctrl;
+#else
+    std::int8_t ctrl[FLAT_GROUP_WIDTH];
+#endif
+
+public:
+    explicit Group(const std::int8_t* pos) {
+#ifdef FLAT_HASH_TABLE_SSE2
+        ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+#else
+        std::memcpy(ctrl, pos, FLAT_GROUP_WIDTH);
+#endif
+    }
+
+    GroupMask match(std::int8_t h2) const {
+#ifdef FLAT_HASH_TABLE_SSE2
+        return GroupMask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+#else
+        std::uint32_t m {0};
+        for (int i = 0; i < FLAT_GROUP_WIDTH; i++) if (ctrl[i] == h2) m |= 1u << i;
+        return GroupMask(m);
+#endif
+    }
+
+    GroupMask matchEmpty() const { return match(CTRL_EMPTY); }
+
+    // both EMPTY and DELETED have the sign bit set, full slots do not
+    GroupMask matchEmptyOrDeleted() const {
+#ifdef FLAT_HASH_TABLE_SSE2
+        return GroupMask(_mm_movemask_epi8(ctrl));
+#else
+        std::uint32_t m {0};
+        for (int i = 0; i < FLAT_GROUP_WIDTH; i++) if (ctrl[i] < 0) m |= 1u << i;
+        return GroupMask(m);
+#endif
+    }
+};
+
+
+template<typename K, typename V, typename Hash = DefaultHash<K>>
+class FlatHashTable {
+private:
+    std::int8_t* ctrl;
+    flat_slot<K, V>* slots;
+    int capacity;
+    int _size;
+    int deleted;
+
+    Hash hasher;
+
+    // h1 (upper bits) picks the group, h2 (low 7 bits) goes into the control byte
+    std::size_t hash(const K& key) const { return hasher(key); }
+
+    static std::int8_t h2(std::size_t h) { return static_cast<std::int8_t>(h & 0x7F); }
+
+    int groupCount() const { return capacity / FLAT_GROUP_WIDTH; }
+
+    // first group of the probe sequence, later groups follow triangular steps
+    int firstGroup(std::size_t h) const { return static_cast<int>((h >> 7) & (groupCount() - 1)); }
+
+    static int roundCapacity(int c) {
+        int rounded = FLAT_GROUP_WIDTH;
+
+        while (rounded < c) rounded *= 2;
+
+        return rounded;
+    }
+
+    void allocate(int c) {
+        capacity = c;
+        ctrl = new std::int8_t[capacity];
+        std::memset(ctrl, CTRL_EMPTY, capacity);
+        slots = static_cast<flat_slot<K, V>*>(::operator new(sizeof(flat_slot<K, V>) * capacity));
+        _size = 0;
+        deleted = 0;
+    }
+
+    void cleanup() {
+        for (int i = 0; i < capacity; i++) if (ctrl[i] >= 0) slots[i].~flat_slot<K, V>();
+
+        ::operator delete(slots);
+        delete[] ctrl;
+    }
+
+    int findIndex(const K& key) const {
+        std::size_t h = hash(key);
+        int group = firstGroup(h);
+        int groupMask = groupCount() - 1;
+
+        for (int step = 1; ; step++) {
+            Group g(ctrl + group * FLAT_GROUP_WIDTH);
+
+            for (GroupMask m = g.match(h2(h)); m.any(); m.next()) {
+                int index = group * FLAT_GROUP_WIDTH + m.lowest();
+
+                if (slots[index].key == key) return index;
+            }
+
+            // an empty slot ends every probe sequence that passes through this group
+            if (g.matchEmpty().any()) return -1;
+
+            group = (group + step) & groupMask;
+        }
+    }
+
+    // first EMPTY or DELETED slot on the probe sequence of h
+    int findInsertSlot(std::size_t h) const {
+        int group = firstGroup(h);
+        int groupMask = groupCount() - 1;
+
+        for (int step = 1; ; step++) {
+            GroupMask m = Group(ctrl + group * FLAT_GROUP_WIDTH).matchEmptyOrDeleted();
+
+            if (m.any()) return group * FLAT_GROUP_WIDTH + m.lowest();
+
+            group = (group + step) & groupMask;
+        }
+    }
+
+    void resize(int newCapacity) {
+        std::int8_t* oldCtrl = ctrl;
+        flat_slot<K, V>* oldSlots = slots;
+        int oldCapacity = capacity;
+        int oldSize = _size;
+
+        allocate(newCapacity);
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldCtrl[i] < 0) continue;
+
+            std::size_t h = hash(oldSlots[i].key);
+            int index = findInsertSlot(h);
+
+            // the old slot is destroyed right after, so its contents move instead of being copied
+            new (&slots[index]) flat_slot<K, V>(std::move(oldSlots[i].key), std::move(oldSlots[i].value));
+            ctrl[index] = h2(h);
+            oldSlots[i].~flat_slot<K, V>();
+        }
+
+        _size = oldSize;
+
+        ::operator delete(oldSlots);
+        delete[] oldCtrl;
+    }
+
+    void copyFrom(const FlatHashTable<K, V, Hash>& other) {
+        allocate(other.capacity);
+
+        // same capacity and hash, so every slot keeps its position
+        std::memcpy(ctrl, other.ctrl, capacity);
+
+        for (int i = 0; i < capacity; i++) {
+            if (ctrl[i] >= 0) new (&slots[i]) flat_slot<K, V>(other.slots[i].key, other.slots[i].value);
+        }
+
+        _size = other._size;
+        deleted = other.deleted;
+    }
+
+public:
+    FlatHashTable(int c = FLAT_DEFAULT_CAPACITY) {
+        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
+
+        allocate(roundCapacity(c));
+    }
+
+    ~FlatHashTable() { cleanup(); }
+
+    FlatHashTable(const FlatHashTable<K, V, Hash>& other) { copyFrom(other); }
+
+    FlatHashTable<K, V, Hash>& operator=(const FlatHashTable<K, V, Hash>& other) {
+        // check self-assignment
+        if (this == &other) return *this;
+
+        cleanup();
+        copyFrom(other);
+
+        return *this;
+    }
+
+    void put(const K& key, const V& value) {
+        int index = findIndex(key);
+
+        if (index >= 0) {
+            slots[index].value = value;
+            return;
+        }
+
+        // tombstones count against the load factor since they lengthen probes
+        if (_size + deleted + 1 > capacity * FLAT_MAX_LF) {
+            // mostly tombstones: rehash in place instead of growing
+            if (_size * 2 < capacity * FLAT_MAX_LF) resize(capacity);
+            else resize(capacity * 2);
+        }
+
+        std::size_t h = hash(key);
+        index = findInsertSlot(h);
+
+        if (ctrl[index] == CTRL_DELETED) deleted--;
+
+        new (&slots[index]) flat_slot<K, V>(key, value);
+        ctrl[index] = h2(h);
+
+        _size++;
+    }
+
+    V get(const K& key) const {
+        int index = findIndex(key);
+
+        if (index < 0) throw std::out_of_range("Key not found");
+
+        return slots[index].value;
+    }
+
+    V* find(const K& key) {
+        int index = findIndex(key);
+
+        return index < 0 ? nullptr : &slots[index].value;
+    }
+
+    const V* find(const K& key) const {
+        int index = findIndex(key);
+
+        return index < 0 ? nullptr : &slots[index].value;
+    }
+
+    bool tryGet(const K& key, V& out) const {
+        int index = findIndex(key);
+
+        if (index < 0) return false;
+
+        out = slots[index].value;
+        return true;
+    }
+
+    V getOrDefault(const K& key, const V& value) const {
+        int index = findIndex(key);
+
+        return index < 0 ? value : slots[index].value;
+    }
+
+    void remove(const K& key) {
+        int index = findIndex(key);
+
+        if (index < 0) throw std::out_of_range("Key not found");
+
+        slots[index].~flat_slot<K, V>();
+
+        // probes only continue past full groups, so a group that still has an EMPTY can take another
+        int group = index / FLAT_GROUP_WIDTH;
+
+        if (Group(ctrl + group * FLAT_GROUP_WIDTH).matchEmpty().any()) ctrl[index] = CTRL_EMPTY;
+        else {
+            ctrl[index] = CTRL_DELETED;
+            deleted++;
+        }
+
+        _size--;
+
+        if (capacity > FLAT_DEFAULT_CAPACITY && static_cast<double>(_size) / capacity < FLAT_MIN_LF) resize(capacity / 2);
+    }
+
+    bool containsKey(const K& key) const { return findIndex(key) >= 0; }
+
+    bool containsValue(const V& value) const {
+        for (int i = 0; i < capacity; i++) {
+            if (ctrl[i] >= 0 && slots[i].value == value) return true;
+        }
+
+        return false;
+    }
+
+    int size() const { return _size; }
+
+    bool isEmpty() const { return _size == 0; }
+
+    void clear(int c = FLAT_DEFAULT_CAPACITY) {
+        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
+
+        cleanup();
+        allocate(roundCapacity(c));
+    }
+};
+
+#endif
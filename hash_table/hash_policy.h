@@ -0,0 +1,161 @@
+#ifndef HASH_POLICY_H
+#define HASH_POLICY_H
+
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+
+
+// every policy returns 64 well-mixed bits, so a table can pick its bucket with a mask
+
+
+// murmur3 fmix64: two multiply-xorshift rounds spread every input bit over the whole word
+inline std::uint64_t mixBits(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+
+    return h;
+}
+
+
+// 64x64 -> 128 bit multiply folded back to 64 bits
+inline std::uint64_t foldedMultiply(std::uint64_t a, std::uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+    std::uint64_t aLow = a & 0xffffffffULL, aHigh = a >> 32;
+    std::uint64_t bLow = b & 0xffffffffULL, bHigh = b >> 32;
+    std::uint64_t low = aLow * bLow, mid1 = aHigh * bLow, mid2 = aLow * bHigh, high = aHigh * bHigh;
+    std::uint64_t carry = ((low >> 32) + (mid1 & 0xffffffffULL) + (mid2 & 0xffffffffULL)) >> 32;
+
+    high += (mid1 >> 32) + (mid2 >> 32) + carry;
+    low += (mid1 << 32) + (mid2 << 32);
+
+    return low ^ high;
+#endif
+}
+
+
+// number of set bits; MSVC has no __builtin_popcount, and its __popcnt needs the POPCNT
+// instruction, so it gets the SWAR count
+inline int popCount(std::uint32_t x) {
+#ifdef _MSC_VER
+    x -= (x >> 1) & 0x55555555u;
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0f0f0f0fu;
+
+    return static_cast<int>((x * 0x01010101u) >> 24);
+#else
+    return __builtin_popcount(x);
+#endif
+}
+
+
+// wyhash-style byte hash: 16 bytes per folded multiply, short inputs in a single round
+inline std::uint64_t hashBytes(const char* p, std::size_t len) {
+    static const std::uint64_t P0 {0xa0761d6478bd642fULL};
+    static const std::uint64_t P1 {0xe7037ed1a0b428dbULL};
+
+    auto read64 = [](const char* q) { std::uint64_t v; std::memcpy(&v, q, 8); return v; };
+    auto read32 = [](const char* q) { std::uint32_t v; std::memcpy(&v, q, 4); return static_cast<std::uint64_t>(v); };
+
+    std::uint64_t seed = P0;
+    std::uint64_t a, b;
+
+    if (len <= 16) {
+        if (len >= 4) {
+            // two overlapping reads from each end cover 4..16 bytes without a loop
+            std::size_t shift = (len >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + shift);
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16)
+                | (static_cast<std::uint64_t>(static_cast<unsigned char>(p[len >> 1])) << 8)
+                | static_cast<unsigned char>(p[len - 1]);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        std::size_t i = len;
+
+        while (i > 16) {
+            seed = foldedMultiply(read64(p) ^ P1, read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+
+    return foldedMultiply(P1 ^ len, foldedMultiply(a ^ P1, b ^ seed));
+}
+
+
+// integers: std::hash is the identity, which puts strided keys in the same masked bucket
+template<typename K>
+struct IntegerHash {
+    std::size_t operator()(K key) const { return mixBits(static_cast<std::uint64_t>(key)); }
+};
+
+
+// transparent: std::string, std::string_view and C strings with the same contents hash alike
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const { return hashBytes(s.data(), s.size()); }
+    std::size_t operator()(const std::string& s) const { return hashBytes(s.data(), s.size()); }
+    std::size_t operator()(const char* s) const { return hashBytes(s, std::strlen(s)); }
+};
+
+
+// policies that accept lookup types other than K (e.g. std::string_view for std::string) declare is_transparent
+template<typename H, typename = void>
+struct is_transparent_hash : std::false_type {};
+
+template<typename H>
+struct is_transparent_hash<H, std::void_t<typename H::is_transparent>> : std::true_type {};
+
+
+// whether DefaultHash<T> can hash T (std::hash is enabled for it)
+template<typename T, typename = void>
+struct is_hashable : std::false_type {};
+
+template<typename T>
+struct is_hashable<T, std::void_t<decltype(std::hash<T>()(std::declval<const T&>()))>> : std::true_type {};
+
+
+// std::hash as-is, the pre-policy behaviour; kept for comparison benchmarks
+template<typename K>
+struct StdHash {
+    std::size_t operator()(const K& key) const { return std::hash<K>()(key); }
+};
+
+
+// any other key type: std::hash followed by a finalizer
+template<typename K, typename = void>
+struct DefaultHash {
+    std::size_t operator()(const K& key) const { return mixBits(std::hash<K>()(key)); }
+};
+
+template<typename K>
+struct DefaultHash<K, typename std::enable_if<std::is_integral<K>::value || std::is_enum<K>::value>::type>
+    : IntegerHash<K> {};
+
+template<>
+struct DefaultHash<std::string> : StringHash {};
+
+template<>
+struct DefaultHash<std::string_view> : StringHash {};
+
+#endif
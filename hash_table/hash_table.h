@@ -2,14 +2,105 @@
 #define HASH_TABLE_H
 
 
+#include "node_pool.h"
+#include "hash_policy.h"
+#include "membership_filter.h"
 #include <stdexcept>
 #include <functional>
+#include <type_traits>
+#include <utility>
+#include <iterator>
+#include <thread>
 #include <iostream>
 
+#ifdef HASH_TABLE_STATS
+#include <atomic>
+#include <chrono>
+#endif
+
 
 static const int DEFAULT_CAPACITY {16};
 static const float MIN_LF {0.25f};
 static const float MAX_LF {0.75f};
+static const int REHASH_STEP {8};
+static const int BATCH_DISTANCE {8};
+static const int BULK_PARTITION_BUCKETS {1 << 14};
+
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HASH_TABLE_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define HASH_TABLE_PREFETCH(addr) ((void)(addr))
+#endif
+
+
+#ifdef HASH_TABLE_STATS
+// operation counters, compiled in only with -DHASH_TABLE_STATS. updates are relaxed load + store,
+// never a locked read-modify-write: concurrent readers of one table may lose counts, nothing more
+struct hash_table_counters {
+    std::atomic<long long> reads {0};
+    std::atomic<long long> readHits {0};
+    std::atomic<long long> searches {0};
+    std::atomic<long long> searchProbes {0};
+    std::atomic<long long> filterRejects {0};
+    std::atomic<long long> inserts {0};
+    std::atomic<long long> overwrites {0};
+    std::atomic<long long> removes {0};
+    std::atomic<long long> removeProbes {0};
+    std::atomic<long long> resizes {0};
+    std::atomic<long long> resizeNanos {0};
+    std::atomic<long long> maxResizeNanos {0};
+
+    static void add(std::atomic<long long>& counter, long long n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+// times the enclosing resize or rehash step
+class resize_timer {
+private:
+    hash_table_counters& counters;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit resize_timer(hash_table_counters& c) : counters(c), start(std::chrono::steady_clock::now()) {}
+
+    ~resize_timer() {
+        long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        hash_table_counters::add(counters.resizeNanos, nanos);
+
+        if (nanos > counters.maxResizeNanos.load(std::memory_order_relaxed)) {
+            counters.maxResizeNanos.store(nanos, std::memory_order_relaxed);
+        }
+    }
+};
+
+#define HASH_TABLE_STAT(counter, n) hash_table_counters::add(counters.counter, n)
+#define HASH_TABLE_RESIZE_TIMER resize_timer timer(counters)
+#else
+#define HASH_TABLE_STAT(counter, n) ((void)0)
+#define HASH_TABLE_RESIZE_TIMER ((void)0)
+#endif
+
+
+#ifdef HASH_TABLE_STATS
+// snapshot of the counters
+struct HashTableStats {
+    long long reads;
+    long long readHits;
+    long long searches;
+    long long searchProbes;
+    long long filterRejects;
+    long long inserts;
+    long long overwrites;
+    long long removes;
+    long long removeProbes;
+    long long resizes;
+    long long resizeNanos;
+    long long maxResizeNanos;
+};
+#endif
 
 
 template<typename K, typename V>
@@ -17,42 +108,427 @@ struct node {
     K key;
     V value;
     node* next;
+    // full hash of key, computed once on insert
+    std::size_t hash;
 
-    node(K k, V v) : key(k), value(v) {}
+    // key and value are built in place from whatever the caller forwarded
+    template<typename KK, typename... Args>
+    node(std::size_t h, KK&& k, Args&&... args) : key(std::forward<KK>(k)), value(std::forward<Args>(args)...), hash(h) {}
 };
 
 
-template<typename K, typename V>
+template<typename K, typename V, typename Hash = DefaultHash<K>>
 class HashTable {
 private:
     node<K, V>** table;
     int capacity;
     int _size;
 
-    std::size_t hash(K key) const {
-        std::hash<K> hasher;
+    // incremental rehash state: oldTable is drained into table a few buckets per operation
+    node<K, V>** oldTable;
+    int oldCapacity;
+    int rehashIndex;
+    bool incremental;
+
+    // every node of both tables lives in the pool
+    NodePool<node<K, V>> pool;
+
+    Hash hasher;
+
+    // optional filter over the cached hashes of every key; during an incremental rehash the shadow
+    // filter collects the keys already in table and replaces filter once oldTable drains
+    MembershipFilter filterType;
+    HashFilter* filter;
+    HashFilter* shadowFilter;
+
+    // optional reverse index, value -> number of keys holding it, for containsValue
+    HashTable<V, int>* valueIndex;
+
+#ifdef HASH_TABLE_STATS
+    mutable hash_table_counters counters;
+#endif
+
+    // capacities are powers of two, so the bucket is the low bits of the hash
+    static std::size_t index(std::size_t h, int c) { return h & (c - 1); }
+
+    static int roundCapacity(int c) {
+        int rounded {2};
+
+        while (rounded < c) rounded *= 2;
+
+        return rounded;
+    }
+
+    // head of the only chain that may hold a key with hash h
+    node<K, V>** bucket(std::size_t h) const {
+        if (oldTable) {
+            std::size_t i = index(h, oldCapacity);
+
+            // bucket not migrated yet
+            if (i >= static_cast<std::size_t>(rehashIndex)) return &oldTable[i];
+        }
+
+        return &table[index(h, capacity)];
+    }
+
+    // Q can be searched for directly: either K itself or any type a transparent hash accepts
+    template<typename Q>
+    static constexpr bool heterogeneous =
+        std::is_same<typename std::decay<Q>::type, K>::value || is_transparent_hash<Hash>::value;
+
+    // cheap hash comparison first, key equality only on a full-hash match
+    template<typename Q>
+    node<K, V>* findNode(const Q& key, std::size_t h) const {
+        HASH_TABLE_STAT(searches, 1);
+
+        // a definite miss costs one filter probe instead of a chain walk
+        if (filter && !filter->mayContain(h)) {
+            HASH_TABLE_STAT(filterRejects, 1);
+            return nullptr;
+        }
+
+        node<K, V>* temp = *bucket(h);
+        int probes {0};
+
+        while (temp) {
+            probes++;
+
+            if (temp->hash == h && temp->key == key) break;
+
+            temp = temp->next;
+        }
+
+        HASH_TABLE_STAT(searchProbes, probes);
+
+        return temp;
+    }
+
+    // key lookups on behalf of get, find, containsKey and friends
+    template<typename Q>
+    node<K, V>* lookup(const Q& key) const {
+        node<K, V>* temp;
+
+        if constexpr (heterogeneous<Q>) temp = findNode(key, hasher(key));
+        else {
+            K k(key);
+            temp = findNode(k, hasher(k));
+        }
+
+        HASH_TABLE_STAT(reads, 1);
+        HASH_TABLE_STAT(readHits, temp != nullptr);
+
+        return temp;
+    }
+
+    // growth check shared by every inserting call
+    void beforeInsert() {
+        // a new resize never starts while the previous one is still draining
+        if (oldTable) rehashStep();
+        else if (static_cast<double>(_size) / capacity > MAX_LF) startResize(capacity * 2);
+    }
+
+    // smallest power-of-two capacity, at least c, that keeps n entries under MAX_LF
+    static int capacityFor(int n, int c) {
+        while (static_cast<double>(n) / c > MAX_LF) c *= 2;
+
+        return c;
+    }
+
+    // one stop-the-world resize sized for n entries (batch inserts); incremental tables grow as usual
+    void growFor(int n) {
+        if (incremental) return;
+
+        int c = capacityFor(n, capacity);
+
+        if (c != capacity) resize(c);
+    }
+
+    template<typename Q>
+    std::size_t hashOf(const Q& key) const {
+        if constexpr (heterogeneous<Q>) return hasher(key);
+        else return hasher(K(key));
+    }
+
+    // software pipeline over a batch: while key i is resolved, the chain head of key i + D
+    // and the bucket slot of key i + 2D are already in flight, so their cache misses overlap
+    template<typename Q, typename Visit>
+    void pipelined(const Q* keys, int count, Visit visit) const {
+        const int D {BATCH_DISTANCE};
+        const int RING {4 * BATCH_DISTANCE};
+
+        std::size_t hashes[RING];
+
+        for (int i = -2 * D; i < count; i++) {
+            int ahead = i + 2 * D;
+
+            if (ahead < count) {
+                hashes[ahead % RING] = hashOf(keys[ahead]);
+                HASH_TABLE_PREFETCH(bucket(hashes[ahead % RING]));
+            }
+
+            // the slot is looked up again rather than kept, since visit may have resized the table
+            int mid = i + D;
+
+            if (mid >= 0 && mid < count) {
+                node<K, V>* head = *bucket(hashes[mid % RING]);
+
+                if (head) HASH_TABLE_PREFETCH(head);
+            }
+
+            if (i >= 0) visit(i, hashes[i % RING]);
+        }
+    }
+
+    // runs task(0) .. task(threads - 1), all but the last on worker threads
+    template<typename Task>
+    static void parallel(int threads, Task task) {
+        std::thread* workers = new std::thread[threads - 1];
+
+        for (int t = 0; t < threads - 1; t++) workers[t] = std::thread(task, t);
+
+        task(threads - 1);
+
+        for (int t = 0; t < threads - 1; t++) workers[t].join();
+
+        delete[] workers;
+    }
+
+    // bulk load into an empty table, in three passes over contiguous bucket ranges (partitions):
+    //   1. hash every key and count entries per partition, per thread
+    //   2. build every node in one slab run, grouped by partition and stable within it
+    //   3. link each partition's nodes; its buckets are few enough to stay in cache
+    // threads own disjoint input slices in passes 1-2 and disjoint partitions in pass 3
+    template<typename It>
+    void bulkLoad(It first, int n, int threads) {
+        delete[] table;
+        capacity = capacityFor(n, capacity);
+        table = new node<K, V>*[capacity]();
+
+        if (n == 0) return;
+
+        int partBuckets = capacity < BULK_PARTITION_BUCKETS ? capacity : BULK_PARTITION_BUCKETS;
+        int partitions = capacity / partBuckets;
+        int shift {0};
+
+        while ((1 << shift) < partBuckets) shift++;
+
+        if (threads > n) threads = n;
+
+        std::size_t* hashes = new std::size_t[n];
+        // counts[t * partitions + p]: entries of slice t in partition p, later its first slot
+        int* counts = new int[threads * partitions]();
+        int* partStart = new int[partitions + 1];
+
+        auto slice = [n, threads](int t) { return static_cast<int>(static_cast<long long>(n) * t / threads); };
+
+        parallel(threads, [&](int t) {
+            int* local = counts + t * partitions;
+
+            for (int i = slice(t); i < slice(t + 1); i++) {
+                hashes[i] = hasher(first[i].first);
+                local[index(hashes[i], capacity) >> shift]++;
+            }
+        });
+
+        // slots ordered by partition, then slice, then input position
+        int running {0};
+
+        for (int p = 0; p < partitions; p++) {
+            partStart[p] = running;
+
+            for (int t = 0; t < threads; t++) {
+                int count = counts[t * partitions + p];
+                counts[t * partitions + p] = running;
+                running += count;
+            }
+        }
+
+        partStart[partitions] = running;
+
+        void* run = pool.allocateRun(n);
+
+        parallel(threads, [&](int t) {
+            int* cursor = counts + t * partitions;
+
+            for (int i = slice(t); i < slice(t + 1); i++) {
+                int slot = cursor[index(hashes[i], capacity) >> shift]++;
+
+                new (NodePool<node<K, V>>::at(run, slot)) node<K, V>(hashes[i], first[i].first, first[i].second);
+            }
+        });
+
+        delete[] hashes;
+        delete[] counts;
+
+        // duplicates of one key share a partition; the later node's value wins and the node is dropped
+        int* linked = new int[threads]();
+        node<K, V>** dropped = new node<K, V>*[threads]();
+
+        parallel(threads, [&](int t) {
+            int lastPart = static_cast<int>(static_cast<long long>(partitions) * (t + 1) / threads);
+
+            for (int p = static_cast<int>(static_cast<long long>(partitions) * t / threads); p < lastPart; p++) {
+                for (int j = partStart[p]; j < partStart[p + 1]; j++) {
+                    node<K, V>* newNode = static_cast<node<K, V>*>(NodePool<node<K, V>>::at(run, j));
+                    node<K, V>** head = &table[index(newNode->hash, capacity)];
+                    node<K, V>* temp = *head;
+
+                    while (temp && !(temp->hash == newNode->hash && temp->key == newNode->key)) temp = temp->next;
+
+                    if (temp) {
+                        temp->value = std::move(newNode->value);
+                        newNode->next = dropped[t];
+                        dropped[t] = newNode;
+                    } else {
+                        newNode->next = *head;
+                        *head = newNode;
+                        linked[t]++;
+                    }
+                }
+            }
+        });
+
+        for (int t = 0; t < threads; t++) {
+            _size += linked[t];
+
+            while (dropped[t]) {
+                node<K, V>* temp = dropped[t];
+                dropped[t] = temp->next;
+                pool.destroy(temp);
+            }
+        }
+
+        delete[] partStart;
+        delete[] linked;
+        delete[] dropped;
+    }
+
+    template<typename Visit>
+    void forEachNode(Visit visit) const {
+        node<K, V>* temp;
+
+        for (int i = 0; i < capacity; i++) {
+            for (temp = table[i]; temp; temp = temp->next) visit(temp);
+        }
+
+        // buckets below rehashIndex are already empty
+        for (int i = oldTable ? rehashIndex : oldCapacity; i < oldCapacity; i++) {
+            for (temp = oldTable[i]; temp; temp = temp->next) visit(temp);
+        }
+    }
+
+    // visit(length) for every chain of both tables
+    template<typename Visit>
+    void forEachChain(Visit visit) const {
+        auto walk = [&](node<K, V>** buckets, int from, int to) {
+            for (int i = from; i < to; i++) {
+                int length {0};
+
+                for (node<K, V>* temp = buckets[i]; temp; temp = temp->next) length++;
+
+                visit(length);
+            }
+        };
+
+        walk(table, 0, capacity);
+
+        if (oldTable) walk(oldTable, rehashIndex, oldCapacity);
+    }
+
+    // a filter for capacity c holds up to the load factor limit
+    static int filterSize(int c) { return static_cast<int>(c * MAX_LF) + 1; }
+
+    // whether a key with hash h belongs in table rather than in a not yet migrated bucket of oldTable
+    bool migrated(std::size_t h) const {
+        return !oldTable || index(h, oldCapacity) < static_cast<std::size_t>(rehashIndex);
+    }
+
+    // fresh filter for the current capacity, which also drops a Bloom filter's stale bits
+    void rebuildFilter() {
+        delete filter;
+        delete shadowFilter;
+        filter = shadowFilter = nullptr;
+
+        if (filterType == MembershipFilter::NONE) return;
+
+        filter = new HashFilter(filterType, filterSize(capacity));
+        forEachNode([this](const node<K, V>* n) { filter->insert(n->hash); });
+    }
+
+    void indexValue(const V& value) {
+        if constexpr (is_hashable<V>::value) {
+            if (!valueIndex) return;
+
+            int* count = valueIndex->find(value);
+
+            if (count) (*count)++;
+            else valueIndex->put(value, 1);
+        }
+    }
+
+    void unindexValue(const V& value) {
+        if constexpr (is_hashable<V>::value) {
+            if (!valueIndex) return;
+
+            int* count = valueIndex->find(value);
+
+            if (--*count == 0) valueIndex->remove(value);
+        }
+    }
+
+    // overwrite of an existing entry, keeping the value index in step
+    template<typename VV>
+    void assignValue(node<K, V>* n, VV&& value) {
+        HASH_TABLE_STAT(overwrites, 1);
+
+        if (valueIndex) {
+            unindexValue(n->value);
+            n->value = std::forward<VV>(value);
+            indexValue(n->value);
+        } else {
+            n->value = std::forward<VV>(value);
+        }
+    }
+
+    void linkNode(node<K, V>* newNode) {
+        node<K, V>** head = bucket(newNode->hash);
+        newNode->next = *head;
+        *head = newNode;
 
-        return hasher(key) % capacity;
+        indexValue(newNode->value);
+        HASH_TABLE_STAT(inserts, 1);
+
+        if (filter) {
+            filter->insert(newNode->hash);
+
+            if (shadowFilter && migrated(newNode->hash)) shadowFilter->insert(newNode->hash);
+        }
+
+        _size++;
     }
 
     void resize(int newCapacity) {
+        HASH_TABLE_RESIZE_TIMER;
+        HASH_TABLE_STAT(resizes, 1);
+
         node<K, V>** newTable = new node<K, V>*[newCapacity]();
 
-        int oldCapacity = capacity;
+        int previousCapacity = capacity;
         capacity = newCapacity;
 
         node<K, V>* temp;
 
-        for (int i = 0; i < oldCapacity; i++) {
+        for (int i = 0; i < previousCapacity; i++) {
             temp = table[i];
 
             while (temp) {
-                std::size_t index = hash(temp->key);
+                // cached hash: no key is rehashed
+                std::size_t newIndex = index(temp->hash, capacity);
 
                 // mutate in-place
                 table[i] = temp->next;
-                temp->next = newTable[index];
-                newTable[index] = temp;
+                temp->next = newTable[newIndex];
+                newTable[newIndex] = temp;
 
                 temp = table[i];
             }
@@ -60,198 +536,433 @@ private:
 
         delete[] table;
         table = newTable;
+
+        if (filter) rebuildFilter();
     }
 
-    void cleanup() {
+    void startResize(int newCapacity) {
+        if (!incremental) {
+            resize(newCapacity);
+            return;
+        }
+
+        HASH_TABLE_STAT(resizes, 1);
+
+        oldTable = table;
+        oldCapacity = capacity;
+        rehashIndex = 0;
+
+        table = new node<K, V>*[newCapacity]();
+        capacity = newCapacity;
+
+        if (filter) shadowFilter = new HashFilter(filterType, filterSize(newCapacity));
+    }
+
+    // migrate up to REHASH_STEP buckets from oldTable
+    void rehashStep(int buckets = REHASH_STEP) {
+        HASH_TABLE_RESIZE_TIMER;
+
+        node<K, V>* temp;
+
+        for (int moved = 0; moved < buckets && rehashIndex < oldCapacity; moved++, rehashIndex++) {
+            temp = oldTable[rehashIndex];
+
+            while (temp) {
+                std::size_t i = index(temp->hash, capacity);
+
+                // mutate in-place
+                oldTable[rehashIndex] = temp->next;
+                temp->next = table[i];
+                table[i] = temp;
+
+                if (shadowFilter) shadowFilter->insert(temp->hash);
+
+                temp = oldTable[rehashIndex];
+            }
+        }
+
+        if (rehashIndex == oldCapacity) {
+            delete[] oldTable;
+            oldTable = nullptr;
+
+            if (shadowFilter) {
+                delete filter;
+                filter = shadowFilter;
+                shadowFilter = nullptr;
+            }
+        }
+    }
+
+    void finishRehash() {
+        if (oldTable) rehashStep(oldCapacity);
+    }
+
+    void destroyChains(node<K, V>** buckets, int c) {
         node<K, V>* temp1;
         node<K, V>* temp2;
 
-        for (int i = 0; i < capacity; i++) {
-            temp1 = table[i];
+        for (int i = 0; i < c; i++) {
+            temp1 = buckets[i];
 
             while (temp1) {
                 temp2 = temp1;
                 temp1 = temp1->next;
-                delete temp2;
+                temp2->~node<K, V>();
             }
         }
+    }
+
+    // nodes go back with their slabs; chains are walked only when K or V need destructors
+    void cleanup() {
+        if constexpr (!std::is_trivially_destructible<K>::value || !std::is_trivially_destructible<V>::value) {
+            destroyChains(table, capacity);
+
+            if (oldTable) destroyChains(oldTable, oldCapacity);
+        }
 
         delete[] table;
+        delete[] oldTable;
+        pool.releaseAll();
+
+        delete filter;
+        delete shadowFilter;
+        filter = shadowFilter = nullptr;
     }
 
-public:
-    HashTable(int c = DEFAULT_CAPACITY) : _size(0) {
-        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
+    // deep copy buckets [lo, hi) of other, where the buckets of other.oldTable follow those of
+    // other.table, into the slots of run starting at slot; every node keeps its bucket and order.
+    // returns the next free slot
+    int copyBuckets(const HashTable<K, V, Hash>& other, int lo, int hi, void* run, int slot) {
+        for (int i = lo; i < hi; i++) {
+            node<K, V>* const* from = i < capacity ? &other.table[i] : &other.oldTable[i - capacity];
+            node<K, V>** to = i < capacity ? &table[i] : &oldTable[i - capacity];
+
+            for (node<K, V>* temp = *from; temp; temp = temp->next) {
+                node<K, V>* newNode = new (NodePool<node<K, V>>::at(run, slot++)) node<K, V>(temp->hash, temp->key, temp->value);
+                *to = newNode;
+                to = &newNode->next;
+            }
 
-        capacity = c;
-        table = new node<K, V>*[capacity]();
+            *to = nullptr;
+        }
+
+        return slot;
     }
 
-    ~HashTable() { cleanup(); }
+    // the copy is one slab run; with several threads each takes a contiguous bucket range and the
+    // matching part of the run, found by counting its nodes first, so threads share no allocator state
+    void copyFrom(const HashTable<K, V, Hash>& other, int threads = 1) {
+        capacity = other.capacity;
+        oldCapacity = other.oldCapacity;
+        rehashIndex = other.rehashIndex;
+        incremental = other.incremental;
 
-    HashTable(const HashTable<K, V>& other) 
-        : _size(other._size), capacity(other.capacity), table(new node<K, V>*[other.capacity]()) { 
-        node<K, V>* temp1;
-        node<K, V>* temp2;
+        // every bucket is written by the copy, so neither array needs zeroing
+        table = new node<K, V>*[capacity];
+        // mid-rehash copies keep the same split between both tables
+        oldTable = other.oldTable ? new node<K, V>*[oldCapacity] : nullptr;
 
-        for (int i = 0; i < capacity; i++) {
-            if (other.table[i]) {
-                // copy first node in the chain
-                temp1 = other.table[i];
-                node<K, V>* newNode = new node<K, V>(temp1->key, temp1->value);
-                newNode->next = nullptr;
-                table[i] = newNode;
-                temp2 = newNode;
-                temp1 = temp1->next;
+        int buckets = capacity + (oldTable ? oldCapacity : 0);
+        void* run = pool.allocateRun(other._size);
+
+        if (threads > buckets) threads = buckets;
+
+        if (threads == 1) {
+            copyBuckets(other, 0, buckets, run, 0);
+        } else {
+            auto range = [buckets, threads](int t) { return static_cast<int>(static_cast<long long>(buckets) * t / threads); };
+            int* start = new int[threads + 1]();
 
-                // copy rest of nodes
-                while (temp1) {
-                    temp2->next = new node<K, V>(temp1->key, temp1->value);
-                    temp2 = temp2->next;
-                    temp1 = temp1->next;
+            parallel(threads, [&](int t) {
+                int count {0};
+
+                for (int i = range(t); i < range(t + 1); i++) {
+                    node<K, V>* temp = i < capacity ? other.table[i] : other.oldTable[i - capacity];
+
+                    for (; temp; temp = temp->next) count++;
                 }
-            }
+
+                start[t + 1] = count;
+            });
+
+            for (int t = 0; t < threads; t++) start[t + 1] += start[t];
+
+            parallel(threads, [&](int t) { copyBuckets(other, range(t), range(t + 1), run, start[t]); });
+
+            delete[] start;
         }
+
+        _size = other._size;
+
+        filterType = other.filterType;
+        filter = shadowFilter = nullptr;
+        rebuildFilter();
+
+        valueIndex = other.valueIndex ? new HashTable<V, int>(*other.valueIndex, threads) : nullptr;
     }
 
-    HashTable<K, V>& operator=(const HashTable<K, V>& other) {
-        // check self-assignment
-        if (this == &other) return *this;
+public:
+    HashTable(int c = DEFAULT_CAPACITY) 
+        : _size(0), oldTable(nullptr), oldCapacity(0), rehashIndex(0), incremental(false),
+          filterType(MembershipFilter::NONE), filter(nullptr), shadowFilter(nullptr), valueIndex(nullptr) {
+        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
 
-        cleanup();
-        capacity = other.capacity;
+        capacity = roundCapacity(c);
         table = new node<K, V>*[capacity]();
+    }
 
-        node<K, V>* temp1;
-        node<K, V>* temp2;
+    // bulk constructor from a range of pairs (anything with .first and .second), e.g. a
+    // std::vector<std::pair<K, V>>; equivalent to put for each pair in order, so the last duplicate wins.
+    // random-access ranges are sized once and built in one pass over the input, spread over
+    // threads threads; other ranges fall back to reserve and put
+    template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    HashTable(It first, It last, int threads = 1) : HashTable(DEFAULT_CAPACITY) {
+        if (threads < 1) throw std::invalid_argument("Thread count must be at least 1");
 
-        for (int i = 0; i < capacity; i++) {
-            if (other.table[i]) {
-                // copy first node in the chain
-                temp1 = other.table[i];
-                node<K, V>* newNode = new node<K, V>(temp1->key, temp1->value);
-                newNode->next = nullptr;
-                table[i] = newNode;
-                temp2 = newNode;
-                temp1 = temp1->next;
+        using category = typename std::iterator_traits<It>::iterator_category;
 
-                // copy rest of nodes
-                while (temp1) {
-                    temp2->next = new node<K, V>(temp1->key, temp1->value);
-                    temp2 = temp2->next;
-                    temp1 = temp1->next;
-                }
-            }
+        if constexpr (std::is_base_of<std::random_access_iterator_tag, category>::value) {
+            bulkLoad(first, static_cast<int>(last - first), threads);
+        } else {
+            reserve(static_cast<int>(std::distance(first, last)));
+
+            for (; first != last; ++first) put(first->first, first->second);
         }
+    }
 
-        _size = other._size;
+    ~HashTable() {
+        cleanup();
+        delete valueIndex;
+    }
+
+    HashTable(const HashTable<K, V, Hash>& other) { copyFrom(other); }
+
+    // copy of other built by threads threads, each cloning its own range of buckets
+    HashTable(const HashTable<K, V, Hash>& other, int threads) {
+        if (threads < 1) throw std::invalid_argument("Thread count must be at least 1");
+
+        copyFrom(other, threads);
+    }
+
+    HashTable<K, V, Hash>& operator=(const HashTable<K, V, Hash>& other) {
+        assign(other);
 
         return *this;
     }
 
-    void put(K key, V value) {
-        std::size_t index = hash(key);
+    // operator= spread over threads threads
+    void assign(const HashTable<K, V, Hash>& other, int threads = 1) {
+        if (threads < 1) throw std::invalid_argument("Thread count must be at least 1");
 
-        if (static_cast<double>(_size) / capacity > MAX_LF) {
-            resize(capacity * 2);
-            index = hash(key);
-        }
+        // check self-assignment
+        if (this == &other) return;
 
-        node<K, V>* temp = table[index];
+        cleanup();
+        delete valueIndex;
+        copyFrom(other, threads);
+    }
 
-        while (temp) {
-            if (temp->key == key) {
-                temp->value = value;
+    // takes keys and values by forwarding reference: rvalues are moved into the node, never copied
+    template<typename KK = K, typename VV = V>
+    void put(KK&& key, VV&& value) {
+        if constexpr (!heterogeneous<KK>) {
+            put(K(std::forward<KK>(key)), std::forward<VV>(value));
+        } else {
+            beforeInsert();
+
+            std::size_t h = hasher(key);
+            node<K, V>* temp = findNode(key, h);
+
+            if (temp) {
+                assignValue(temp, std::forward<VV>(value));
                 return;
             }
 
-            temp = temp->next;
+            linkNode(pool.create(h, std::forward<KK>(key), std::forward<VV>(value)));
         }
+    }
 
-        node<K, V>* newNode = new node<K, V>(key, value);
-        newNode->next = table[index];
-        table[index] = newNode;
-        
-        _size++;
+    // constructs the entry in place from key and value arguments; keeps an existing entry untouched
+    template<typename KK, typename... Args>
+    bool emplace(KK&& key, Args&&... args) {
+        beforeInsert();
+
+        node<K, V>* newNode = pool.create(0, std::forward<KK>(key), std::forward<Args>(args)...);
+        newNode->hash = hasher(newNode->key);
+
+        if (findNode(newNode->key, newNode->hash)) {
+            pool.destroy(newNode);
+            return false;
+        }
+
+        linkNode(newNode);
+        return true;
     }
 
-    V get(K key) const {
-        std::size_t index = hash(key);
+    // like emplace, but looks the key up first so nothing is constructed when it already exists
+    template<typename KK, typename... Args>
+    bool tryEmplace(KK&& key, Args&&... args) {
+        if constexpr (!heterogeneous<KK>) {
+            return tryEmplace(K(std::forward<KK>(key)), std::forward<Args>(args)...);
+        } else {
+            beforeInsert();
 
-        node<K, V>* temp = table[index];
+            std::size_t h = hasher(key);
 
-        while (temp) {
-            if (temp->key == key) return temp->value;
+            if (findNode(key, h)) return false;
 
-            temp = temp->next;
+            linkNode(pool.create(h, std::forward<KK>(key), std::forward<Args>(args)...));
+            return true;
         }
+    }
 
-        throw std::out_of_range("Key not found");
+    template<typename Q = K>
+    const V& get(const Q& key) const {
+        node<K, V>* temp = lookup(key);
+
+        if (!temp) throw std::out_of_range("Key not found");
+
+        return temp->value;
     }
 
-    V getOrDefault(K key, V value) {
-        try {
-            return get(key);
-        } catch (const std::out_of_range&) {
-            return value;
-        }
+    // non-throwing lookups: a miss costs the same as a hit
+    template<typename Q = K>
+    V* find(const Q& key) {
+        node<K, V>* temp = lookup(key);
+
+        return temp ? &temp->value : nullptr;
     }
 
-    void remove(K key) {
-        std::size_t index = hash(key);
-        bool removed {false};
+    template<typename Q = K>
+    const V* find(const Q& key) const {
+        node<K, V>* temp = lookup(key);
 
-        node<K, V>* temp = table[index];
+        return temp ? &temp->value : nullptr;
+    }
 
-        // in case of first node
-        if (temp && temp->key == key) {
-            table[index] = temp->next;
-            delete temp;
-            removed = true;
+    template<typename Q = K>
+    bool tryGet(const Q& key, V& out) const {
+        node<K, V>* temp = lookup(key);
 
-        } else{
-            node<K, V>* trail = temp;
-            temp = temp->next;
+        if (!temp) return false;
 
-            while (temp) {
-                if (temp->key == key) {
-                    trail->next = temp->next;
-                    delete temp;
-                    removed = true;
-                    break;
-                }
+        out = temp->value;
+        return true;
+    }
 
-                temp = temp->next;
-                trail = trail->next;
-            }
-        }
+    template<typename Q = K>
+    V getOrDefault(const Q& key, const V& value) const {
+        node<K, V>* temp = lookup(key);
 
-        if (removed) {
-            _size--;
+        return temp ? temp->value : value;
+    }
 
-            if (capacity > DEFAULT_CAPACITY && static_cast<double>(_size) / capacity < MIN_LF) resize(capacity / 2);
+    // results[i] points to the value of keys[i] or is nullptr; returns the number of hits
+    template<typename Q>
+    int getMany(const Q* keys, int count, const V** results) const {
+        int found {0};
 
-            return;
-        }
+        pipelined(keys, count, [&](int i, std::size_t h) {
+            node<K, V>* temp;
+
+            if constexpr (heterogeneous<Q>) temp = findNode(keys[i], h);
+            else temp = findNode(K(keys[i]), h);
+
+            results[i] = temp ? &temp->value : nullptr;
+            found += temp != nullptr;
+        });
 
-        throw std::out_of_range("Key not found");
+        HASH_TABLE_STAT(reads, count);
+        HASH_TABLE_STAT(readHits, found);
+
+        return found;
     }
 
-    bool containsKey(K key) const {
-        std::size_t index = hash(key);
+    template<typename Q>
+    int containsMany(const Q* keys, int count, bool* results) const {
+        int found {0};
 
-        node<K, V>* temp = table[index];
+        pipelined(keys, count, [&](int i, std::size_t h) {
+            if constexpr (heterogeneous<Q>) results[i] = findNode(keys[i], h) != nullptr;
+            else results[i] = findNode(K(keys[i]), h) != nullptr;
 
-        while (temp) {
-            if (temp->key == key) return true;
+            found += results[i];
+        });
 
-            temp = temp->next;
-        }
+        HASH_TABLE_STAT(reads, count);
+        HASH_TABLE_STAT(readHits, found);
 
-        return false;
+        return found;
+    }
+
+    // same result as put(keys[i], values[i]) in order; later duplicates win
+    void putMany(const K* keys, const V* values, int count) {
+        // size once up front so the batch does not resize part way through
+        growFor(_size + count);
+
+        pipelined(keys, count, [&](int i, std::size_t h) {
+            beforeInsert();
+
+            node<K, V>* temp = findNode(keys[i], h);
+
+            if (temp) assignValue(temp, values[i]);
+            else linkNode(pool.create(h, keys[i], values[i]));
+        });
     }
 
-    bool containsValue(V value) const {
+    template<typename Q = K>
+    void remove(const Q& key) {
+        if constexpr (!heterogeneous<Q>) {
+            remove(K(key));
+        } else {
+            if (oldTable) rehashStep();
+
+            std::size_t h = hasher(key);
+
+            HASH_TABLE_STAT(removes, 1);
+
+            // walk the links themselves so the first node needs no special case
+            node<K, V>** link = bucket(h);
+
+            while (*link) {
+                HASH_TABLE_STAT(removeProbes, 1);
+
+                if ((*link)->hash == h && (*link)->key == key) {
+                    node<K, V>* temp = *link;
+                    *link = temp->next;
+                    unindexValue(temp->value);
+                    pool.destroy(temp);
+
+                    if (filter) {
+                        filter->remove(h);
+
+                        if (shadowFilter && migrated(h)) shadowFilter->remove(h);
+                    }
+
+                    _size--;
+
+                    if (!oldTable && capacity > DEFAULT_CAPACITY && static_cast<double>(_size) / capacity < MIN_LF) {
+                        startResize(capacity / 2);
+                    }
+
+                    return;
+                }
+
+                link = &(*link)->next;
+            }
+
+            throw std::out_of_range("Key not found");
+        }
+    }
+
+    template<typename Q = K>
+    bool containsKey(const Q& key) const { return lookup(key) != nullptr; }
+
+    bool containsValue(const V& value) const {
+        if constexpr (is_hashable<V>::value) {
+            if (valueIndex) return valueIndex->containsKey(value);
+        }
+
         node<K, V>* temp;
 
         for (int i = 0; i < capacity; i++) {
@@ -264,9 +975,156 @@ public:
             }
         }
 
+        // buckets below rehashIndex are already empty
+        for (int i = oldTable ? rehashIndex : oldCapacity; i < oldCapacity; i++) {
+            temp = oldTable[i];
+
+            while (temp) {
+                if (temp->value == value) return true;
+
+                temp = temp->next;
+            }
+        }
+
         return false;
     }
 
+    // calls visit(key, value) once per entry, in no particular order
+    template<typename Visit>
+    void forEach(Visit visit) const {
+        forEachNode([&visit](const node<K, V>* n) { visit(n->key, n->value); });
+    }
+
+    // spread every resize over the following put/remove calls instead of rehashing in one go
+    void setIncrementalRehash(bool enabled) {
+        if (!enabled) finishRehash();
+
+        incremental = enabled;
+    }
+
+    bool isRehashing() const { return oldTable != nullptr; }
+
+    // heap bytes held by the table itself: bucket arrays, node pool (live and free nodes), filters
+    // and value index; memory owned by keys and values (e.g. string buffers) is not included
+    std::size_t memoryUsage() const {
+        std::size_t bytes = sizeof(*this) + pool.bytes() + sizeof(node<K, V>*) * capacity;
+
+        if (oldTable) bytes += sizeof(node<K, V>*) * oldCapacity;
+        if (filter) bytes += filter->bytes();
+        if (shadowFilter) bytes += shadowFilter->bytes();
+        if (valueIndex) bytes += valueIndex->memoryUsage();
+
+        return bytes;
+    }
+
+    // counts[i] = buckets whose chain has i nodes, the last entry collects all longer chains;
+    // walks every bucket on each call, so ordinary operations pay nothing for it
+    void chainHistogram(long long* counts, int lengths) const {
+        for (int i = 0; i < lengths; i++) counts[i] = 0;
+
+        forEachChain([&](int length) { counts[length < lengths ? length : lengths - 1]++; });
+    }
+
+#ifdef HASH_TABLE_STATS
+    HashTableStats stats() const {
+        return {counters.reads, counters.readHits, counters.searches, counters.searchProbes,
+                counters.filterRejects, counters.inserts, counters.overwrites, counters.removes,
+                counters.removeProbes, counters.resizes, counters.resizeNanos, counters.maxResizeNanos};
+    }
+#endif
+
+    // human-readable report: shape and memory always, operation counters with -DHASH_TABLE_STATS
+    void dumpStats(std::ostream& out = std::cout) const {
+        static const int LENGTHS {9};
+        long long counts[LENGTHS];
+        int longest {0};
+
+        for (int i = 0; i < LENGTHS; i++) counts[i] = 0;
+
+        forEachChain([&](int length) {
+            counts[length < LENGTHS ? length : LENGTHS - 1]++;
+
+            if (length > longest) longest = length;
+        });
+
+        out << "size: " << _size << ", capacity: " << capacity;
+
+        if (oldTable) out << " (rehashing from " << oldCapacity << ")";
+
+        out << ", load factor: " << static_cast<double>(_size) / capacity << "\n";
+        out << "memory: " << memoryUsage() << " bytes\n";
+        out << "chain lengths:";
+
+        for (int i = 0; i < LENGTHS; i++) out << " " << i << (i == LENGTHS - 1 ? "+: " : ": ") << counts[i];
+
+        out << ", longest: " << longest << "\n";
+
+#ifdef HASH_TABLE_STATS
+        HashTableStats s = stats();
+
+        auto ratio = [](long long a, long long b) { return b ? static_cast<double>(a) / b : 0.0; };
+
+        out << "reads: " << s.reads << " (hit rate " << ratio(s.readHits, s.reads) * 100 << "%)\n";
+        out << "searches: " << s.searches << ", probes per search: " << ratio(s.searchProbes, s.searches);
+
+        if (filter || s.filterRejects) out << ", filtered out: " << s.filterRejects;
+
+        out << "\n";
+        out << "inserts: " << s.inserts << ", overwrites: " << s.overwrites << "\n";
+        out << "removes: " << s.removes << ", probes per remove: " << ratio(s.removeProbes, s.removes) << "\n";
+        out << "resizes: " << s.resizes << ", resize time: " << s.resizeNanos / 1e6 << " ms"
+            << " (longest single step " << s.maxResizeNanos / 1e6 << " ms)\n";
+#endif
+    }
+
+    // keep a membership filter in front of every key lookup so most misses skip the chain walk:
+    // BLOOM is smaller, CUCKOO also forgets removed keys; NONE switches it off
+    void setMembershipFilter(MembershipFilter type) {
+        filterType = type;
+        rebuildFilter();
+    }
+
+    // maintain a value -> count index so containsValue is O(1) average instead of a full scan;
+    // costs an extra hash update on every put, overwrite and remove.
+    // values changed in place through find() bypass the index, so use put while it is on
+    void setValueIndex(bool enabled) {
+        static_assert(is_hashable<V>::value, "A value index needs a hashable value type");
+
+        delete valueIndex;
+        valueIndex = nullptr;
+
+        if (!enabled) return;
+
+        valueIndex = new HashTable<V, int>();
+        forEachNode([this](const node<K, V>* n) { indexValue(n->value); });
+    }
+
+    bool hasValueIndex() const { return valueIndex != nullptr; }
+
+    FilterStats filterStats() const {
+        if (!filter) return {MembershipFilter::NONE, 0, 1.0, false};
+
+        FilterStats stats = filter->stats();
+
+        // while rehashing both filters take memory
+        if (shadowFilter) stats.bytes += shadowFilter->stats().bytes;
+
+        return stats;
+    }
+
+    // make room for n entries in total: at most one resize now and none until size exceeds n
+    void reserve(int n) {
+        if (n < 0) throw std::invalid_argument("Reserved size must be non-negative");
+
+        finishRehash();
+
+        int c = capacityFor(n, capacity);
+
+        if (c != capacity) resize(c);
+
+        if (n > _size) pool.reserve(n - _size);
+    }
+
     int size() const { return _size; }
 
     bool isEmpty() const { return _size == 0; }
@@ -276,11 +1134,15 @@ public:
 
         cleanup();
 
-        table = new node<K, V>*[c]();
+        capacity = roundCapacity(c);
+        table = new node<K, V>*[capacity]();
+        oldTable = nullptr;
         _size = 0;
-        capacity = c;
+
+        rebuildFilter();
+
+        if (valueIndex) valueIndex->clear();
     }
 };
 
 #endif
-
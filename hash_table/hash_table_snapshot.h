@@ -0,0 +1,294 @@
+#ifndef HASH_TABLE_SNAPSHOT_H
+#define HASH_TABLE_SNAPSHOT_H
+
+
+#include "hash_table.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// file layout (native byte order, every section 8-byte aligned):
+//   snapshot_header
+//   std::uint64_t offsets[bucketCount + 1]   entries of bucket b are [offsets[b], offsets[b + 1])
+//   snapshot_entry<K, V> entries[count]      grouped by bucket
+// nothing in the file is a pointer, so it can be mapped at any address
+
+static const char SNAPSHOT_MAGIC[8] {'H', 'T', 'S', 'N', 'A', 'P', '\0', '\0'};
+static const std::uint32_t SNAPSHOT_VERSION {1};
+
+
+struct snapshot_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t entrySize;
+    std::uint64_t count;
+    std::uint64_t bucketCount;
+    std::uint64_t entriesOffset;
+};
+
+
+template<typename K, typename V>
+struct snapshot_entry {
+    std::uint64_t hash;
+    K key;
+    V value;
+};
+
+
+inline std::uint64_t snapshotEntriesOffset(std::uint64_t bucketCount, std::size_t align) {
+    std::uint64_t offset = sizeof(snapshot_header) + (bucketCount + 1) * sizeof(std::uint64_t);
+
+    return (offset + align - 1) / align * align;
+}
+
+
+// write all of data to fd, resuming after short writes and signals
+inline bool snapshotWrite(int fd, const void* data, std::size_t size) {
+    const char* p = static_cast<const char*>(data);
+
+    while (size > 0) {
+        ssize_t written = write(fd, p, size);
+
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+
+        p += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+
+// write every entry of table to path, replacing the file; throws std::runtime_error on I/O failure.
+// the snapshot is written and synced under path + ".tmp" and renamed over path, so processes
+// mapping the old file keep a consistent view and a failed save leaves the old file in place.
+// the hash policy must give the same result in the process that maps the file
+template<typename K, typename V, typename Hash>
+void saveSnapshot(const HashTable<K, V, Hash>& table, const std::string& path) {
+    static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+                  "snapshots store keys and values as raw bytes");
+
+    using entry = snapshot_entry<K, V>;
+
+    Hash hasher;
+    std::uint64_t count = table.size();
+    std::uint64_t bucketCount = 1;
+
+    // about one entry per bucket keeps each probe to a single short run
+    while (bucketCount < count) bucketCount *= 2;
+
+    std::uint64_t mask = bucketCount - 1;
+    std::uint64_t* offsets = new std::uint64_t[bucketCount + 1]();
+    entry* entries = new entry[count];
+
+    // counting sort by bucket: histogram, prefix sums, then scatter
+    table.forEach([&](const K& key, const V&) { offsets[(hasher(key) & mask) + 1]++; });
+
+    for (std::uint64_t b = 0; b < bucketCount; b++) offsets[b + 1] += offsets[b];
+
+    std::uint64_t* fill = new std::uint64_t[bucketCount];
+    std::memcpy(fill, offsets, bucketCount * sizeof(std::uint64_t));
+
+    table.forEach([&](const K& key, const V& value) {
+        std::uint64_t h = hasher(key);
+        entry& e = entries[fill[h & mask]++];
+
+        std::memset(&e, 0, sizeof(entry));
+        e.hash = h;
+        e.key = key;
+        e.value = value;
+    });
+
+    delete[] fill;
+
+    snapshot_header header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.entrySize = sizeof(entry);
+    header.count = count;
+    header.bucketCount = bucketCount;
+    header.entriesOffset = snapshotEntriesOffset(bucketCount, alignof(entry));
+
+    std::uint64_t offsetsEnd = sizeof(snapshot_header) + (bucketCount + 1) * sizeof(std::uint64_t);
+    static const char padding[alignof(entry)] {};
+
+    std::string temp = path + ".tmp";
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0;
+
+    ok = ok && snapshotWrite(fd, &header, sizeof(header));
+    ok = ok && snapshotWrite(fd, offsets, (bucketCount + 1) * sizeof(std::uint64_t));
+    ok = ok && snapshotWrite(fd, padding, header.entriesOffset - offsetsEnd);
+    ok = ok && snapshotWrite(fd, entries, count * sizeof(entry));
+    ok = ok && fsync(fd) == 0;
+
+    if (fd >= 0 && close(fd) != 0) ok = false;
+
+    delete[] offsets;
+    delete[] entries;
+
+    // rename replaces the directory entry atomically; mappings of the old file stay valid
+    if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+        if (fd >= 0) unlink(temp.c_str());
+
+        throw std::runtime_error("Could not write snapshot " + path);
+    }
+}
+
+
+// read-only view of a snapshot file; lookups run directly against the mapping, so opening costs
+// one mmap and a pass over the bucket offsets, and processes that map the same file share its
+// page cache
+template<typename K, typename V, typename Hash = DefaultHash<K>>
+class MappedHashTable {
+private:
+    using entry = snapshot_entry<K, V>;
+
+    void* base;
+    std::size_t length;
+
+    const std::uint64_t* offsets;
+    const entry* entries;
+    std::uint64_t count;
+    std::uint64_t mask;
+
+    Hash hasher;
+
+    const entry* findEntry(const K& key) const {
+        std::uint64_t h = hasher(key);
+        std::uint64_t b = h & mask;
+
+        for (const entry* e = entries + offsets[b], * end = entries + offsets[b + 1]; e != end; e++) {
+            if (e->hash == h && e->key == key) return e;
+        }
+
+        return nullptr;
+    }
+
+    void fail(const std::string& path, const char* reason) {
+        if (base) munmap(base, length);
+
+        throw std::runtime_error("Could not open snapshot " + path + ": " + reason);
+    }
+
+public:
+    explicit MappedHashTable(const std::string& path) : base(nullptr), length(0) {
+        static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+                      "snapshots store keys and values as raw bytes");
+
+        int fd = open(path.c_str(), O_RDONLY);
+
+        if (fd < 0) fail(path, "cannot open file");
+
+        struct stat info;
+
+        if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(snapshot_header)) {
+            close(fd);
+            fail(path, "file too small");
+        }
+
+        length = info.st_size;
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+
+        // the mapping keeps its own reference to the file
+        close(fd);
+
+        if (mapped == MAP_FAILED) fail(path, "mmap failed");
+
+        base = mapped;
+
+        const snapshot_header* header = static_cast<const snapshot_header*>(base);
+
+        if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) fail(path, "not a snapshot");
+        if (header->version != SNAPSHOT_VERSION) fail(path, "unsupported version");
+        if (header->entrySize != sizeof(entry)) fail(path, "key/value types do not match");
+
+        std::uint64_t bucketCount = header->bucketCount;
+
+        // size checks are divisions against the file length, so a corrupt header cannot overflow them
+        if (bucketCount == 0 || (bucketCount & (bucketCount - 1)) != 0) fail(path, "corrupt header");
+        if (bucketCount >= (length - sizeof(snapshot_header)) / sizeof(std::uint64_t)) fail(path, "truncated file");
+        if (header->entriesOffset != snapshotEntriesOffset(bucketCount, alignof(entry))) fail(path, "corrupt header");
+        if (header->entriesOffset > length) fail(path, "truncated file");
+
+        std::uint64_t entryBytes = length - header->entriesOffset;
+
+        if (entryBytes % sizeof(entry) != 0 || entryBytes / sizeof(entry) != header->count) fail(path, "truncated file");
+
+        offsets = reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(base) + sizeof(snapshot_header));
+        entries = reinterpret_cast<const entry*>(static_cast<const char*>(base) + header->entriesOffset);
+        count = header->count;
+        mask = bucketCount - 1;
+
+        // lookups index entries through any two neighbouring offsets, so all of them must lie in
+        // [0, count]: starting at 0, never decreasing and ending at count guarantees that
+        if (offsets[0] != 0 || offsets[bucketCount] != count) fail(path, "corrupt bucket offsets");
+
+        for (std::uint64_t b = 0; b < bucketCount; b++) {
+            if (offsets[b] > offsets[b + 1]) fail(path, "corrupt bucket offsets");
+        }
+    }
+
+    ~MappedHashTable() { munmap(base, length); }
+
+    // owns the mapping
+    MappedHashTable(const MappedHashTable<K, V, Hash>&) = delete;
+    MappedHashTable<K, V, Hash>& operator=(const MappedHashTable<K, V, Hash>&) = delete;
+
+    const V& get(const K& key) const {
+        const entry* e = findEntry(key);
+
+        if (!e) throw std::out_of_range("Key not found");
+
+        return e->value;
+    }
+
+    const V* find(const K& key) const {
+        const entry* e = findEntry(key);
+
+        return e ? &e->value : nullptr;
+    }
+
+    bool tryGet(const K& key, V& out) const {
+        const entry* e = findEntry(key);
+
+        if (!e) return false;
+
+        out = e->value;
+        return true;
+    }
+
+    V getOrDefault(const K& key, const V& value) const {
+        const entry* e = findEntry(key);
+
+        return e ? e->value : value;
+    }
+
+    bool containsKey(const K& key) const { return findEntry(key) != nullptr; }
+
+    // copy the snapshot into a regular, mutable table
+    HashTable<K, V, Hash> load() const {
+        HashTable<K, V, Hash> table(static_cast<int>(count / MAX_LF) + 2);
+
+        for (std::uint64_t i = 0; i < count; i++) table.put(entries[i].key, entries[i].value);
+
+        return table;
+    }
+
+    int size() const { return static_cast<int>(count); }
+
+    bool isEmpty() const { return count == 0; }
+};
+
+#endif
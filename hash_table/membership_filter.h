@@ -0,0 +1,292 @@
+#ifndef MEMBERSHIP_FILTER_H
+#define MEMBERSHIP_FILTER_H
+
+
+#include "hash_policy.h"
+#include <cstdint>
+#include <cstddef>
+
+
+// filters work on the 64-bit hash a table already caches, never on keys;
+// a "no" is definite, a "maybe" still needs the real lookup
+
+static const int BLOOM_BITS_PER_KEY {10};
+static const int CUCKOO_BUCKET_SLOTS {4};
+static const float CUCKOO_MAX_LOAD {0.8f};
+static const int CUCKOO_MAX_KICKS {500};
+
+
+enum class MembershipFilter { NONE, BLOOM, CUCKOO };
+
+
+struct FilterStats {
+    MembershipFilter type;
+    std::size_t bytes;
+    // estimated chance that a key not in the table passes the filter
+    double falsePositiveRate;
+    // the filter lost an entry and answers "maybe" for everything until it is rebuilt
+    bool saturated;
+};
+
+
+inline int roundFilterSize(double n) {
+    int rounded {1};
+
+    while (rounded < n) rounded *= 2;
+
+    return rounded;
+}
+
+
+// split-block Bloom filter: every key sets one bit in each of the eight 32-bit words of a
+// single 32-byte block, so insert and lookup touch one cache line. no deletion; removed keys
+// leave their bits set until the owner rebuilds the filter
+class BloomFilter {
+private:
+    struct alignas(32) block {
+        std::uint32_t words[8];
+    };
+
+    block* blocks;
+    int blockMask;
+
+    // odd multipliers that pick an independent bit for each word
+    static std::uint32_t mask(std::uint32_t h, int word) {
+        static const std::uint32_t SALT[8] {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+        };
+
+        return 1u << ((h * SALT[word]) >> 27);
+    }
+
+public:
+    explicit BloomFilter(int expected) {
+        int count = roundFilterSize(static_cast<double>(expected) * BLOOM_BITS_PER_KEY / 256);
+
+        blocks = new block[count]();
+        blockMask = count - 1;
+    }
+
+    ~BloomFilter() { delete[] blocks; }
+
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    // the table takes its bucket from the low bits, so the block comes from the high ones
+    void insert(std::uint64_t h) {
+        block& b = blocks[(h >> 32) & blockMask];
+
+        for (int i = 0; i < 8; i++) b.words[i] |= mask(static_cast<std::uint32_t>(h), i);
+    }
+
+    bool mayContain(std::uint64_t h) const {
+        const block& b = blocks[(h >> 32) & blockMask];
+
+        for (int i = 0; i < 8; i++) {
+            if (!(b.words[i] & mask(static_cast<std::uint32_t>(h), i))) return false;
+        }
+
+        return true;
+    }
+
+    std::size_t bytes() const { return sizeof(block) * (blockMask + 1); }
+
+    // a random hash passes when all of its 8 bits are set: about (fraction of bits set)^8
+    double falsePositiveRate() const {
+        std::size_t set {0};
+
+        for (int i = 0; i <= blockMask; i++) {
+            for (int j = 0; j < 8; j++) set += popCount(blocks[i].words[j]);
+        }
+
+        double fraction = static_cast<double>(set) / (bytes() * 8);
+        double rate {1.0};
+
+        for (int i = 0; i < 8; i++) rate *= fraction;
+
+        return rate;
+    }
+};
+
+
+// cuckoo filter: a 16-bit fingerprint per key in one of two 4-slot buckets (partial-key cuckoo
+// hashing, the second bucket is derived from the first and the fingerprint alone). supports
+// deletion of keys that were inserted; a lookup reads at most two buckets of 8 bytes
+class CuckooFilter {
+private:
+    std::uint16_t* slots;
+    int bucketMask;
+    int count;
+    bool lost;
+    std::uint32_t victim;
+
+    // fingerprint 0 marks an empty slot; bits 16..31 stay clear of the bucket bits taken from 32 up
+    static std::uint16_t fingerprint(std::uint64_t h) {
+        std::uint16_t f = static_cast<std::uint16_t>(h >> 16);
+
+        return f ? f : 1;
+    }
+
+    int primary(std::uint64_t h) const { return static_cast<int>((h >> 32) & bucketMask); }
+
+    // an involution: applying it to either bucket gives the other one
+    int alternate(int bucket, std::uint16_t f) const {
+        return static_cast<int>((bucket ^ mixBits(f)) & bucketMask);
+    }
+
+    bool hasFingerprint(int bucket, std::uint16_t f) const {
+        const std::uint16_t* s = slots + bucket * CUCKOO_BUCKET_SLOTS;
+
+        return s[0] == f || s[1] == f || s[2] == f || s[3] == f;
+    }
+
+    bool place(int bucket, std::uint16_t f) {
+        std::uint16_t* s = slots + bucket * CUCKOO_BUCKET_SLOTS;
+
+        for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) {
+            if (!s[i]) {
+                s[i] = f;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool erase(int bucket, std::uint16_t f) {
+        std::uint16_t* s = slots + bucket * CUCKOO_BUCKET_SLOTS;
+
+        for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) {
+            if (s[i] == f) {
+                s[i] = 0;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+public:
+    explicit CuckooFilter(int expected) : count(0), lost(false), victim(0x9e3779b9U) {
+        int buckets = roundFilterSize(expected / (CUCKOO_BUCKET_SLOTS * CUCKOO_MAX_LOAD));
+
+        slots = new std::uint16_t[buckets * CUCKOO_BUCKET_SLOTS]();
+        bucketMask = buckets - 1;
+    }
+
+    ~CuckooFilter() { delete[] slots; }
+
+    CuckooFilter(const CuckooFilter&) = delete;
+    CuckooFilter& operator=(const CuckooFilter&) = delete;
+
+    void insert(std::uint64_t h) {
+        if (lost) return;
+
+        std::uint16_t f = fingerprint(h);
+        int i1 = primary(h);
+        int i2 = alternate(i1, f);
+
+        count++;
+
+        if (place(i1, f) || place(i2, f)) return;
+
+        // both buckets full: evict a random resident and move it to its other bucket
+        int bucket = i2;
+
+        for (int kick = 0; kick < CUCKOO_MAX_KICKS; kick++) {
+            victim ^= victim << 13;
+            victim ^= victim >> 17;
+            victim ^= victim << 5;
+
+            std::uint16_t& s = slots[bucket * CUCKOO_BUCKET_SLOTS + victim % CUCKOO_BUCKET_SLOTS];
+            std::uint16_t evicted = s;
+            s = f;
+            f = evicted;
+
+            bucket = alternate(bucket, f);
+
+            if (place(bucket, f)) return;
+        }
+
+        // the fingerprint in hand has no home; answering "maybe" keeps lookups correct
+        lost = true;
+    }
+
+    // only for hashes that were inserted, otherwise another key's fingerprint may go
+    void remove(std::uint64_t h) {
+        if (lost) return;
+
+        std::uint16_t f = fingerprint(h);
+        int i1 = primary(h);
+
+        if (erase(i1, f) || erase(alternate(i1, f), f)) count--;
+    }
+
+    bool mayContain(std::uint64_t h) const {
+        if (lost) return true;
+
+        std::uint16_t f = fingerprint(h);
+        int i1 = primary(h);
+
+        return hasFingerprint(i1, f) || hasFingerprint(alternate(i1, f), f);
+    }
+
+    bool saturated() const { return lost; }
+
+    std::size_t bytes() const { return sizeof(std::uint16_t) * CUCKOO_BUCKET_SLOTS * (bucketMask + 1); }
+
+    // a random hash is compared against the occupied slots of two buckets, 1/65535 chance each
+    double falsePositiveRate() const {
+        if (lost) return 1.0;
+
+        double occupancy = static_cast<double>(count) / (CUCKOO_BUCKET_SLOTS * (bucketMask + 1));
+
+        return 2.0 * CUCKOO_BUCKET_SLOTS * occupancy / 65535.0;
+    }
+};
+
+
+// the filter a table keeps alongside its buckets, of the type chosen at runtime
+class HashFilter {
+private:
+    MembershipFilter type;
+    BloomFilter* bloom;
+    CuckooFilter* cuckoo;
+
+public:
+    HashFilter(MembershipFilter t, int expected) : type(t), bloom(nullptr), cuckoo(nullptr) {
+        if (type == MembershipFilter::BLOOM) bloom = new BloomFilter(expected);
+        else cuckoo = new CuckooFilter(expected);
+    }
+
+    ~HashFilter() {
+        delete bloom;
+        delete cuckoo;
+    }
+
+    HashFilter(const HashFilter&) = delete;
+    HashFilter& operator=(const HashFilter&) = delete;
+
+    void insert(std::uint64_t h) {
+        if (bloom) bloom->insert(h);
+        else cuckoo->insert(h);
+    }
+
+    // Bloom filters cannot forget; their stale bits go at the next rebuild
+    void remove(std::uint64_t h) {
+        if (cuckoo) cuckoo->remove(h);
+    }
+
+    bool mayContain(std::uint64_t h) const { return bloom ? bloom->mayContain(h) : cuckoo->mayContain(h); }
+
+    std::size_t bytes() const { return bloom ? bloom->bytes() : cuckoo->bytes(); }
+
+    FilterStats stats() const {
+        if (bloom) return {type, bloom->bytes(), bloom->falsePositiveRate(), false};
+
+        return {type, cuckoo->bytes(), cuckoo->falsePositiveRate(), cuckoo->saturated()};
+    }
+};
+
+#endif
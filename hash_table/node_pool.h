@@ -0,0 +1,144 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+
+#include <new>
+#include <cstddef>
+#include <utility>
+
+
+static const int POOL_FIRST_SLAB {16};
+static const int POOL_MAX_SLAB {4096};
+
+
+// slab allocator for fixed-size nodes: slots are carved from large chunks and recycled through
+// an intrusive free list, so steady-state insert/remove never reaches the global allocator
+template<typename T>
+class NodePool {
+private:
+    // a free slot reuses its own storage as the free-list link
+    union slot {
+        slot* nextFree;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct slab {
+        slot* slots;
+        int count;
+        slab* next;
+    };
+
+    slab* slabs;
+    slot* freeList;
+
+    // untouched tail of the newest slab, handed out before growing
+    slot* bump;
+    slot* bumpEnd;
+
+    int nextSlabSize;
+    int slabSlots;
+
+    void addSlab(int count) {
+        slab* s = new slab {new slot[count], count, slabs};
+        slabs = s;
+        slabSlots += count;
+
+        // whatever was left of the previous slab goes to the free list
+        while (bump != bumpEnd) release(bump++);
+
+        bump = s->slots;
+        bumpEnd = s->slots + count;
+    }
+
+public:
+    NodePool()
+        : slabs(nullptr), freeList(nullptr), bump(nullptr), bumpEnd(nullptr), nextSlabSize(POOL_FIRST_SLAB), slabSlots(0) {}
+
+    // does not run destructors; owners destroy live objects first
+    ~NodePool() { releaseAll(); }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    void* allocate() {
+        if (freeList) {
+            slot* s = freeList;
+            freeList = s->nextFree;
+            return s;
+        }
+
+        if (bump == bumpEnd) {
+            addSlab(nextSlabSize);
+
+            // grow geometrically so small tables stay small
+            if (nextSlabSize < POOL_MAX_SLAB) nextSlabSize *= 2;
+        }
+
+        return bump++;
+    }
+
+    void release(void* p) {
+        slot* s = static_cast<slot*>(p);
+        s->nextFree = freeList;
+        freeList = s;
+    }
+
+    template<typename... Args>
+    T* create(Args&&... args) {
+        void* p = allocate();
+
+        try {
+            return new (p) T(std::forward<Args>(args)...);
+        } catch (...) {
+            release(p);
+            throw;
+        }
+    }
+
+    void destroy(T* p) {
+        p->~T();
+        release(p);
+    }
+
+    // make room for n more objects in one contiguous slab
+    void reserve(int n) {
+        if (bumpEnd - bump >= n) return;
+
+        addSlab(n);
+    }
+
+    // n adjacent uninitialized slots from one slab, for callers that place objects themselves;
+    // slot i is at(run, i) and is given back with destroy or release like any other
+    void* allocateRun(int n) {
+        reserve(n);
+
+        slot* run = bump;
+        bump += n;
+
+        return run;
+    }
+
+    static void* at(void* run, int i) { return static_cast<slot*>(run) + i; }
+
+    // drop every slab at once
+    void releaseAll() {
+        while (slabs) {
+            slab* temp = slabs;
+            slabs = slabs->next;
+            delete[] temp->slots;
+            delete temp;
+        }
+
+        freeList = nullptr;
+        bump = bumpEnd = nullptr;
+        nextSlabSize = POOL_FIRST_SLAB;
+        slabSlots = 0;
+    }
+
+    int capacity() const { return slabSlots; }
+
+    // heap memory held by the pool, live or free
+    std::size_t bytes() const { return slabSlots * sizeof(slot); }
+};
+
+#endif
@@ -0,0 +1,471 @@
+#ifndef PERSISTENT_HASH_MAP_H
+#define PERSISTENT_HASH_MAP_H
+
+
+#include "hash_policy.h"
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+
+// 5 hash bits per level: 32-way nodes, at most 13 levels for a 64-bit hash
+static const int HAMT_BITS {5};
+// width of hamt_entry::hash; past it a path is exhausted and equal hashes share a collision node
+static const int HAMT_HASH_BITS {static_cast<int>(sizeof(std::size_t) * CHAR_BIT)};
+static const std::uint32_t HAMT_MASK {(1u << HAMT_BITS) - 1};
+
+
+template<typename K, typename V>
+struct hamt_entry {
+    std::size_t hash;
+    K key;
+    V value;
+
+    hamt_entry(std::size_t h, const K& k, const V& v) : hash(h), key(k), value(v) {}
+};
+
+
+// a trie node keeps its entries and child pointers in one allocation right behind the header.
+// bit i of dataMap / nodeMap says that slot i holds an entry / a child, and both arrays are
+// dense, in slot order, indexed by the popcount of the lower bits. below the last hash bit a
+// node is a plain list of full-hash collisions, with both maps empty
+template<typename K, typename V>
+struct hamt_node {
+    std::atomic<int> refs;
+    std::uint32_t dataMap;
+    std::uint32_t nodeMap;
+    int entryCount;
+    int childCount;
+
+    hamt_node(std::uint32_t d, std::uint32_t n, int e, int c) : refs(1), dataMap(d), nodeMap(n), entryCount(e), childCount(c) {}
+
+    static std::size_t entriesOffset() {
+        return (sizeof(hamt_node) + alignof(hamt_entry<K, V>) - 1) / alignof(hamt_entry<K, V>) * alignof(hamt_entry<K, V>);
+    }
+
+    static std::size_t childrenOffset(int entries) {
+        std::size_t end = entriesOffset() + entries * sizeof(hamt_entry<K, V>);
+
+        return (end + alignof(hamt_node*) - 1) / alignof(hamt_node*) * alignof(hamt_node*);
+    }
+
+    static std::size_t bytes(int entries, int children) { return childrenOffset(entries) + children * sizeof(hamt_node*); }
+
+    hamt_entry<K, V>* entries() {
+        return std::launder(reinterpret_cast<hamt_entry<K, V>*>(reinterpret_cast<char*>(this) + entriesOffset()));
+    }
+
+    hamt_node** children() {
+        return std::launder(reinterpret_cast<hamt_node**>(reinterpret_cast<char*>(this) + childrenOffset(entryCount)));
+    }
+};
+
+
+// persistent hash map (hash array mapped trie). nodes are reference counted and shared between
+// versions: copying a map, i.e. taking a snapshot, is O(1), and an update copies only the nodes on
+// its path that another version still uses, so one version never sees another's changes.
+// a single map object is not thread-safe, but separate versions may be used from different
+// threads, since shared nodes are never modified
+template<typename K, typename V, typename Hash = DefaultHash<K>>
+class PersistentHashMap {
+private:
+    using entry = hamt_entry<K, V>;
+    using trie_node = hamt_node<K, V>;
+
+    trie_node* root;
+    int _size;
+
+    Hash hasher;
+
+    static std::uint32_t bitOf(std::size_t h, int shift) { return 1u << ((h >> shift) & HAMT_MASK); }
+
+    // position of bit's slot in a dense array
+    static int rank(std::uint32_t map, std::uint32_t bit) { return popCount(map & (bit - 1)); }
+
+    // header constructed; the caller constructs every entry and fills every child
+    static trie_node* allocate(std::uint32_t dataMap, std::uint32_t nodeMap, int entryCount, int childCount) {
+        void* p = ::operator new(trie_node::bytes(entryCount, childCount));
+
+        return new (p) trie_node(dataMap, nodeMap, entryCount, childCount);
+    }
+
+    static void retain(trie_node* n) { n->refs.fetch_add(1, std::memory_order_relaxed); }
+
+    static void destroy(trie_node* n) {
+        entry* e = n->entries();
+
+        for (int i = 0; i < n->entryCount; i++) e[i].~entry();
+
+        n->~trie_node();
+        ::operator delete(n);
+    }
+
+    static void release(trie_node* n) {
+        if (!n || n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+        trie_node** c = n->children();
+
+        for (int i = 0; i < n->childCount; i++) release(c[i]);
+
+        destroy(n);
+    }
+
+    // whether this version holds the only reference to n, and may therefore change it in place
+    // or move its contents out; a count of 1 cannot rise behind our back, only our own copies raise it
+    static bool owned(trie_node* n) { return n->refs.load(std::memory_order_acquire) == 1; }
+
+    // moved out of nodes this version owns, copied out of shared ones
+    static void transfer(entry* to, entry& from, bool move) {
+        if (move) new (to) entry(std::move(from));
+        else new (to) entry(from);
+    }
+
+    static void transferChild(trie_node** to, trie_node* child, bool move) {
+        *to = child;
+
+        if (!move) retain(child);
+    }
+
+    // after its contents went into a replacement: an owned node is freed without touching the
+    // children it handed over, a shared one loses this version's reference
+    static void drop(trie_node* n, bool move) {
+        if (move) destroy(n);
+        else release(n);
+    }
+
+    // n itself if owned, otherwise a private copy that shares n's children
+    static trie_node* unique(trie_node* n) {
+        if (owned(n)) return n;
+
+        trie_node* m = allocate(n->dataMap, n->nodeMap, n->entryCount, n->childCount);
+
+        for (int i = 0; i < n->entryCount; i++) transfer(&m->entries()[i], n->entries()[i], false);
+
+        for (int i = 0; i < n->childCount; i++) transferChild(&m->children()[i], n->children()[i], false);
+
+        release(n);
+
+        return m;
+    }
+
+    // a node holding resident and the new entry, as deep as their hashes agree
+    static trie_node* pair(entry& resident, bool move, std::size_t h, const K& key, const V& value, int shift) {
+        if (shift >= HAMT_HASH_BITS) {
+            trie_node* m = allocate(0, 0, 2, 0);
+            transfer(&m->entries()[0], resident, move);
+            new (&m->entries()[1]) entry(h, key, value);
+
+            return m;
+        }
+
+        std::uint32_t residentBit = bitOf(resident.hash, shift);
+        std::uint32_t bit = bitOf(h, shift);
+
+        if (residentBit == bit) {
+            trie_node* m = allocate(0, bit, 0, 1);
+            m->children()[0] = pair(resident, move, h, key, value, shift + HAMT_BITS);
+
+            return m;
+        }
+
+        trie_node* m = allocate(residentBit | bit, 0, 2, 0);
+        int first = residentBit < bit ? 0 : 1;
+
+        transfer(&m->entries()[first], resident, move);
+        new (&m->entries()[1 - first]) entry(h, key, value);
+
+        return m;
+    }
+
+    // each call takes over the caller's reference to n and returns the node to store in its place
+    static trie_node* insert(trie_node* n, std::size_t h, const K& key, const V& value, int shift, bool& added) {
+        if (shift >= HAMT_HASH_BITS) {
+            for (int i = 0; i < n->entryCount; i++) {
+                if (n->entries()[i].key == key) {
+                    n = unique(n);
+                    n->entries()[i].value = value;
+
+                    return n;
+                }
+            }
+
+            bool move = owned(n);
+            trie_node* m = allocate(0, 0, n->entryCount + 1, 0);
+
+            for (int i = 0; i < n->entryCount; i++) transfer(&m->entries()[i], n->entries()[i], move);
+
+            new (&m->entries()[n->entryCount]) entry(h, key, value);
+
+            drop(n, move);
+            added = true;
+
+            return m;
+        }
+
+        std::uint32_t bit = bitOf(h, shift);
+
+        if (n->nodeMap & bit) {
+            n = unique(n);
+
+            trie_node*& child = n->children()[rank(n->nodeMap, bit)];
+            child = insert(child, h, key, value, shift + HAMT_BITS, added);
+
+            return n;
+        }
+
+        bool move = owned(n);
+        trie_node* m;
+
+        if (n->dataMap & bit) {
+            int i = rank(n->dataMap, bit);
+            entry& resident = n->entries()[i];
+
+            if (resident.hash == h && resident.key == key) {
+                n = unique(n);
+                n->entries()[i].value = value;
+
+                return n;
+            }
+
+            // the resident entry and the new one move one level down together
+            int c = rank(n->nodeMap, bit);
+            m = allocate(n->dataMap & ~bit, n->nodeMap | bit, n->entryCount - 1, n->childCount + 1);
+
+            for (int j = 0, k = 0; j < n->entryCount; j++) {
+                if (j != i) transfer(&m->entries()[k++], n->entries()[j], move);
+            }
+
+            for (int j = 0; j < n->childCount; j++) transferChild(&m->children()[j < c ? j : j + 1], n->children()[j], move);
+
+            m->children()[c] = pair(resident, move, h, key, value, shift + HAMT_BITS);
+        } else {
+            int i = rank(n->dataMap, bit);
+            m = allocate(n->dataMap | bit, n->nodeMap, n->entryCount + 1, n->childCount);
+
+            for (int j = 0; j < n->entryCount; j++) transfer(&m->entries()[j < i ? j : j + 1], n->entries()[j], move);
+
+            new (&m->entries()[i]) entry(h, key, value);
+
+            for (int j = 0; j < n->childCount; j++) transferChild(&m->children()[j], n->children()[j], move);
+        }
+
+        drop(n, move);
+        added = true;
+
+        return m;
+    }
+
+    // key must be present. keeps the trie canonical: a node left with a single entry and no
+    // children is folded into its parent, so lookups never pass through a one-entry node
+    static trie_node* erase(trie_node* n, std::size_t h, const K& key, int shift) {
+        bool move = owned(n);
+
+        if (shift >= HAMT_HASH_BITS) {
+            trie_node* m = allocate(0, 0, n->entryCount - 1, 0);
+
+            for (int j = 0, k = 0; j < n->entryCount; j++) {
+                if (!(n->entries()[j].key == key)) transfer(&m->entries()[k++], n->entries()[j], move);
+            }
+
+            drop(n, move);
+
+            return m;
+        }
+
+        std::uint32_t bit = bitOf(h, shift);
+
+        if (n->dataMap & bit) {
+            if (n->entryCount == 1 && n->childCount == 0) {
+                release(n);
+                return nullptr;
+            }
+
+            int i = rank(n->dataMap, bit);
+            trie_node* m = allocate(n->dataMap & ~bit, n->nodeMap, n->entryCount - 1, n->childCount);
+
+            for (int j = 0, k = 0; j < n->entryCount; j++) {
+                if (j != i) transfer(&m->entries()[k++], n->entries()[j], move);
+            }
+
+            for (int j = 0; j < n->childCount; j++) transferChild(&m->children()[j], n->children()[j], move);
+
+            drop(n, move);
+
+            return m;
+        }
+
+        n = unique(n);
+
+        int c = rank(n->nodeMap, bit);
+        trie_node* child = erase(n->children()[c], h, key, shift + HAMT_BITS);
+
+        if (child->childCount > 0 || child->entryCount > 1) {
+            n->children()[c] = child;
+            return n;
+        }
+
+        // the child is down to one entry, which moves up into this node's slot for it;
+        // child and n are both owned here, fresh from erase and unique
+        entry& last = child->entries()[0];
+        trie_node* m;
+
+        if (n->entryCount == 0 && n->childCount == 1) {
+            // n would hold nothing else, so it shrinks to that entry and is folded further up
+            m = allocate(bit, 0, 1, 0);
+            transfer(&m->entries()[0], last, true);
+        } else {
+            int i = rank(n->dataMap, bit);
+            m = allocate(n->dataMap | bit, n->nodeMap & ~bit, n->entryCount + 1, n->childCount - 1);
+
+            for (int j = 0; j < n->entryCount; j++) transfer(&m->entries()[j < i ? j : j + 1], n->entries()[j], true);
+
+            transfer(&m->entries()[i], last, true);
+
+            for (int j = 0, k = 0; j < n->childCount; j++) {
+                if (j != c) m->children()[k++] = n->children()[j];
+            }
+        }
+
+        destroy(child);
+        destroy(n);
+
+        return m;
+    }
+
+    entry* findEntry(const K& key) const {
+        std::size_t h = hasher(key);
+        trie_node* n = root;
+
+        for (int shift = 0; n; shift += HAMT_BITS) {
+            if (shift >= HAMT_HASH_BITS) {
+                for (int i = 0; i < n->entryCount; i++) {
+                    if (n->entries()[i].key == key) return &n->entries()[i];
+                }
+
+                return nullptr;
+            }
+
+            std::uint32_t bit = bitOf(h, shift);
+
+            if (n->dataMap & bit) {
+                entry* e = &n->entries()[rank(n->dataMap, bit)];
+
+                return e->hash == h && e->key == key ? e : nullptr;
+            }
+
+            if (!(n->nodeMap & bit)) return nullptr;
+
+            n = n->children()[rank(n->nodeMap, bit)];
+        }
+
+        return nullptr;
+    }
+
+    template<typename Visit>
+    static void forEachIn(trie_node* n, Visit& visit) {
+        for (int i = 0; i < n->entryCount; i++) visit(n->entries()[i].key, n->entries()[i].value);
+
+        for (int i = 0; i < n->childCount; i++) forEachIn(n->children()[i], visit);
+    }
+
+public:
+    PersistentHashMap() : root(nullptr), _size(0) {}
+
+    ~PersistentHashMap() { release(root); }
+
+    // O(1): the copy shares every node
+    PersistentHashMap(const PersistentHashMap<K, V, Hash>& other) : root(other.root), _size(other._size) {
+        if (root) retain(root);
+    }
+
+    PersistentHashMap<K, V, Hash>& operator=(const PersistentHashMap<K, V, Hash>& other) {
+        // check self-assignment
+        if (this == &other) return *this;
+
+        if (other.root) retain(other.root);
+
+        release(root);
+        root = other.root;
+        _size = other._size;
+
+        return *this;
+    }
+
+    // point-in-time view, unaffected by later changes to this map; same as copying it
+    PersistentHashMap<K, V, Hash> snapshot() const { return *this; }
+
+    void put(const K& key, const V& value) {
+        std::size_t h = hasher(key);
+        bool added {false};
+
+        if (root) {
+            root = insert(root, h, key, value, 0, added);
+        } else {
+            root = allocate(bitOf(h, 0), 0, 1, 0);
+            new (root->entries()) entry(h, key, value);
+            added = true;
+        }
+
+        if (added) _size++;
+    }
+
+    const V& get(const K& key) const {
+        entry* e = findEntry(key);
+
+        if (!e) throw std::out_of_range("Key not found");
+
+        return e->value;
+    }
+
+    // valid until this map is next modified
+    const V* find(const K& key) const {
+        entry* e = findEntry(key);
+
+        return e ? &e->value : nullptr;
+    }
+
+    bool tryGet(const K& key, V& out) const {
+        entry* e = findEntry(key);
+
+        if (!e) return false;
+
+        out = e->value;
+        return true;
+    }
+
+    V getOrDefault(const K& key, const V& value) const {
+        entry* e = findEntry(key);
+
+        return e ? e->value : value;
+    }
+
+    bool containsKey(const K& key) const { return findEntry(key) != nullptr; }
+
+    void remove(const K& key) {
+        if (!findEntry(key)) throw std::out_of_range("Key not found");
+
+        root = erase(root, hasher(key), key, 0);
+        _size--;
+    }
+
+    // visit(key, value) for every entry, in no particular order
+    template<typename Visit>
+    void forEach(Visit visit) const {
+        if (root) forEachIn(root, visit);
+    }
+
+    int size() const { return _size; }
+
+    bool isEmpty() const { return _size == 0; }
+
+    void clear() {
+        release(root);
+        root = nullptr;
+        _size = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,472 @@
+#ifndef SPLIT_ORDERED_HASH_TABLE_H
+#define SPLIT_ORDERED_HASH_TABLE_H
+
+
+#include "epoch.h"
+#include "hash_policy.h"
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <new>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+static const int SPLIT_DEFAULT_CAPACITY {16};
+static const float SPLIT_MAX_LF {0.75f};
+static const int SPLIT_SEGMENTS {32};
+static const int SPLIT_COUNT_BATCH {16};
+
+
+// mirror image of x: bit i moves to bit 63 - i
+inline std::uint64_t reverseBits(std::uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((x & 0x0f0f0f0f0f0f0f0fULL) << 4);
+    x = ((x >> 8) & 0x00ff00ff00ff00ffULL) | ((x & 0x00ff00ff00ff00ffULL) << 8);
+    x = ((x >> 16) & 0x0000ffff0000ffffULL) | ((x & 0x0000ffff0000ffffULL) << 16);
+
+    return (x >> 32) | (x << 32);
+}
+
+
+// entries and bucket sentinels are links of one list sorted by split-order key (the bit-reversed hash).
+// the low bit of next marks the link's owner as deleted, so no thread can link after it any more
+struct split_link {
+    const std::uint64_t order;
+    std::atomic<std::uintptr_t> next;
+
+    explicit split_link(std::uint64_t o) : order(o), next(0) {}
+};
+
+
+template<typename V>
+struct is_lock_free_atomic : std::integral_constant<bool, std::atomic<V>::is_always_lock_free> {};
+
+// values that fit a lock-free atomic are stored in the entry and overwritten in place; anything
+// else sits behind a pointer and an update swaps in a new copy, so readers never see a torn value
+template<typename V, typename = void>
+struct split_value {
+    std::atomic<V*> pointer;
+
+    explicit split_value(const V& v) : pointer(new V(v)) {}
+
+    ~split_value() { delete pointer.load(std::memory_order_relaxed); }
+
+    V load() const { return *pointer.load(std::memory_order_acquire); }
+
+    void store(const V& v, EpochManager& epochs) { epochs.retire(pointer.exchange(new V(v), std::memory_order_acq_rel)); }
+};
+
+template<typename V>
+struct split_value<V, typename std::enable_if<std::conjunction<std::is_trivially_copyable<V>, is_lock_free_atomic<V>>::value>::type> {
+    std::atomic<V> value;
+
+    explicit split_value(const V& v) : value(v) {}
+
+    V load() const { return value.load(std::memory_order_acquire); }
+
+    void store(const V& v, EpochManager&) { value.store(v, std::memory_order_release); }
+};
+
+
+// entries have odd split-order keys, sentinels even ones
+template<typename K, typename V>
+struct split_node : split_link {
+    const K key;
+    split_value<V> value;
+
+    split_node(std::uint64_t o, const K& k, const V& v) : split_link(o), key(k), value(v) {}
+};
+
+
+static const int BUCKET_EMPTY {0};
+static const int BUCKET_CLAIMED {1};
+static const int BUCKET_READY {2};
+
+
+// a bucket's sentinel lives in the segment array itself, so reaching the bucket reaches the list
+struct split_bucket {
+    split_link sentinel;
+    // BUCKET_EMPTY, then BUCKET_CLAIMED while one thread links the sentinel, then BUCKET_READY
+    std::atomic<int> state;
+
+    explicit split_bucket(std::uint64_t order) : sentinel(order), state(BUCKET_EMPTY) {}
+};
+
+
+// lock-free map after Shalev and Shavit: every entry lives in a single sorted lock-free list
+// (Harris-Michael) and buckets are shortcuts into it. sorting by the reversed hash keeps every
+// bucket contiguous at every table size, so doubling the bucket count only adds sentinels, which
+// are linked lazily on first use of their bucket; entries never move. unlinked entries and
+// replaced out-of-line values go to epoch reclamation
+template<typename K, typename V, typename Hash = DefaultHash<K>>
+class SplitOrderedHashTable {
+private:
+    // per-thread share of the size, a cache line each; only the owning thread writes to it
+    struct alignas(64) pending_count {
+        std::atomic<long long> value;
+    };
+
+    // segment s holds buckets [2^s, 2^(s + 1)), segment 0 buckets 0 and 1; allocated on first use
+    // and never moved, so a published bucket slot stays valid while the table grows
+    mutable std::atomic<split_bucket*> segments[SPLIT_SEGMENTS];
+    std::atomic<std::size_t> bucketCount;
+
+    // sentinel of bucket 0, the head of the whole list
+    split_link* head;
+
+    // size is published + the sum of every thread's pending count, flushed in batches
+    std::atomic<long long> published;
+    pending_count* pending;
+
+    mutable EpochManager epochs;
+    Hash hasher;
+
+    static split_link* link(std::uintptr_t word) { return reinterpret_cast<split_link*>(word & ~static_cast<std::uintptr_t>(1)); }
+
+    static std::uintptr_t word(split_link* l) { return reinterpret_cast<std::uintptr_t>(l); }
+
+    // b is nonzero; the count of leading zeros is taken on unsigned long long, so the width
+    // comes from that type and any std::size_t fits
+    static int highestBit(std::size_t b) {
+#ifdef _MSC_VER
+        unsigned long index;
+#ifdef _WIN64
+        _BitScanReverse64(&index, b);
+#else
+        _BitScanReverse(&index, static_cast<unsigned long>(b));
+#endif
+        return static_cast<int>(index);
+#else
+        return static_cast<int>(sizeof(unsigned long long) * CHAR_BIT) - 1 - __builtin_clzll(b);
+#endif
+    }
+
+    static int segmentOf(std::size_t b) { return b < 2 ? 0 : highestBit(b); }
+
+    static std::size_t segmentBase(int s) { return s == 0 ? 0 : static_cast<std::size_t>(1) << s; }
+
+    static std::size_t segmentSize(int s) { return s == 0 ? 2 : static_cast<std::size_t>(1) << s; }
+
+    // entries: the reversed hash with the low bit set, which drops the top bit of the hash
+    static std::uint64_t entryOrder(std::size_t h) { return reverseBits(h) | 1; }
+
+    static std::uint64_t sentinelOrder(std::size_t b) { return reverseBits(b); }
+
+    split_bucket& bucketSlot(std::size_t b) const {
+        int s = segmentOf(b);
+        split_bucket* segment = segments[s].load(std::memory_order_acquire);
+
+        if (!segment) {
+            // buckets hold only atomics and integers, so the storage is released without destructors
+            split_bucket* fresh = static_cast<split_bucket*>(::operator new(segmentSize(s) * sizeof(split_bucket)));
+
+            for (std::size_t i = 0; i < segmentSize(s); i++) new (&fresh[i]) split_bucket(sentinelOrder(segmentBase(s) + i));
+
+            if (segments[s].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                segment = fresh;
+            } else {
+                ::operator delete(fresh);
+            }
+        }
+
+        return segment[b - segmentBase(s)];
+    }
+
+    // walk from start to the first link at or past order, unlinking and retiring marked entries on
+    // the way. with key, a match is an entry of that order and key; without, a sentinel of that
+    // order. on return *prev is the unmarked link that pointed to cur when it was read
+    bool search(split_link* start, std::uint64_t order, const K* key, std::atomic<std::uintptr_t>*& prev, split_link*& cur) const {
+        while (true) {
+            prev = &start->next;
+            cur = link(prev->load(std::memory_order_acquire));
+
+            bool restart {false};
+
+            while (cur) {
+                std::uintptr_t next = cur->next.load(std::memory_order_acquire);
+
+                if (next & 1) {
+                    std::uintptr_t expected = word(cur);
+
+                    // prev changed under us (insert, or its owner got marked): start over
+                    if (!prev->compare_exchange_strong(expected, next & ~static_cast<std::uintptr_t>(1),
+                                                       std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        restart = true;
+                        break;
+                    }
+
+                    epochs.retire(static_cast<split_node<K, V>*>(cur));
+                    cur = link(next);
+                    continue;
+                }
+
+                if (cur->order > order) return false;
+
+                if (cur->order == order && (!key || static_cast<split_node<K, V>*>(cur)->key == *key)) return true;
+
+                prev = &cur->next;
+                cur = link(next);
+            }
+
+            if (!restart) return false;
+        }
+    }
+
+    static std::size_t parentOf(std::size_t b) { return b & ~(static_cast<std::size_t>(1) << highestBit(b)); }
+
+    // a new bucket splits its parent, the same bucket without its top bit, so its sentinel goes
+    // into the parent's run of the list. one thread claims the bucket and links the sentinel;
+    // until it is done everyone else starts from the parent, which reaches the same entries
+    split_link* bucketAt(std::size_t b) const {
+        split_bucket& slot = bucketSlot(b);
+        int state = slot.state.load(std::memory_order_acquire);
+
+        if (state == BUCKET_READY) return &slot.sentinel;
+
+        split_link* parent = bucketAt(parentOf(b));
+
+        if (state == BUCKET_CLAIMED || !slot.state.compare_exchange_strong(state, BUCKET_CLAIMED, std::memory_order_acq_rel)) {
+            return parent;
+        }
+
+        std::atomic<std::uintptr_t>* prev;
+        split_link* cur;
+
+        while (true) {
+            // sentinel orders are unique, so this search never finds a match
+            search(parent, slot.sentinel.order, nullptr, prev, cur);
+
+            slot.sentinel.next.store(word(cur), std::memory_order_relaxed);
+
+            std::uintptr_t expected = word(cur);
+
+            if (prev->compare_exchange_strong(expected, word(&slot.sentinel), std::memory_order_release, std::memory_order_relaxed)) break;
+        }
+
+        slot.state.store(BUCKET_READY, std::memory_order_release);
+
+        return &slot.sentinel;
+    }
+
+    split_link* bucketFor(std::size_t h) const { return bucketAt(h & (bucketCount.load(std::memory_order_relaxed) - 1)); }
+
+    split_node<K, V>* findNode(const K& key) const {
+        std::size_t h = hasher(key);
+        std::atomic<std::uintptr_t>* prev;
+        split_link* cur;
+
+        return search(bucketFor(h), entryOrder(h), &key, prev, cur) ? static_cast<split_node<K, V>*>(cur) : nullptr;
+    }
+
+    // no shared counter on the hot path: the global count, and with it the growth check, is touched
+    // once every SPLIT_COUNT_BATCH net inserts or removes of a thread
+    void count(long long delta) {
+        std::atomic<long long>& local = pending[EpochSlots::current()].value;
+        long long p = local.load(std::memory_order_relaxed) + delta;
+
+        if (p > -SPLIT_COUNT_BATCH && p < SPLIT_COUNT_BATCH) {
+            local.store(p, std::memory_order_relaxed);
+            return;
+        }
+
+        long long total = published.fetch_add(p, std::memory_order_relaxed) + p;
+        local.store(0, std::memory_order_relaxed);
+
+        // growing is one CAS; the new buckets fill in lazily
+        std::size_t c = bucketCount.load(std::memory_order_relaxed);
+
+        while (total > c * SPLIT_MAX_LF && c < (static_cast<std::size_t>(1) << SPLIT_SEGMENTS)) {
+            if (bucketCount.compare_exchange_weak(c, c * 2, std::memory_order_relaxed)) c *= 2;
+        }
+    }
+
+public:
+    SplitOrderedHashTable(int c = SPLIT_DEFAULT_CAPACITY) : published(0) {
+        if (c <= 1) throw std::invalid_argument("Starting capacity must be at least 2");
+
+        std::size_t rounded {2};
+
+        while (rounded < static_cast<std::size_t>(c)) rounded *= 2;
+
+        bucketCount.store(rounded, std::memory_order_relaxed);
+
+        for (int s = 0; s < SPLIT_SEGMENTS; s++) segments[s].store(nullptr, std::memory_order_relaxed);
+
+        pending = new pending_count[MAX_EPOCH_THREADS];
+
+        for (int i = 0; i < MAX_EPOCH_THREADS; i++) pending[i].value.store(0, std::memory_order_relaxed);
+
+        head = &bucketSlot(0).sentinel;
+        bucketSlot(0).state.store(BUCKET_READY, std::memory_order_relaxed);
+    }
+
+    // callers guarantee that no other thread still uses the table
+    ~SplitOrderedHashTable() {
+        split_link* temp = head;
+
+        // sentinels go with their segments
+        while (temp) {
+            split_link* next = link(temp->next.load(std::memory_order_relaxed));
+
+            if (temp->order & 1) delete static_cast<split_node<K, V>*>(temp);
+
+            temp = next;
+        }
+
+        for (int s = 0; s < SPLIT_SEGMENTS; s++) ::operator delete(segments[s].load(std::memory_order_relaxed));
+
+        delete[] pending;
+    }
+
+    // shared between threads by reference, never copied
+    SplitOrderedHashTable(const SplitOrderedHashTable<K, V, Hash>&) = delete;
+    SplitOrderedHashTable<K, V, Hash>& operator=(const SplitOrderedHashTable<K, V, Hash>&) = delete;
+
+    // a new key is one CAS on its predecessor; an existing key has its value replaced
+    void put(const K& key, const V& value) {
+        EpochGuard guard(epochs);
+
+        std::size_t h = hasher(key);
+        split_link* start = bucketFor(h);
+        split_node<K, V>* newNode {nullptr};
+        std::atomic<std::uintptr_t>* prev;
+        split_link* cur;
+
+        while (true) {
+            if (search(start, entryOrder(h), &key, prev, cur)) {
+                static_cast<split_node<K, V>*>(cur)->value.store(value, epochs);
+
+                // built on an earlier round that lost its CAS to another insert of key
+                delete newNode;
+                return;
+            }
+
+            if (!newNode) newNode = new split_node<K, V>(entryOrder(h), key, value);
+
+            newNode->next.store(word(cur), std::memory_order_relaxed);
+
+            std::uintptr_t expected = word(cur);
+
+            if (prev->compare_exchange_strong(expected, word(newNode), std::memory_order_release, std::memory_order_relaxed)) break;
+        }
+
+        count(1);
+    }
+
+    V get(const K& key) const {
+        EpochGuard guard(epochs);
+
+        split_node<K, V>* temp = findNode(key);
+
+        if (!temp) throw std::out_of_range("Key not found");
+
+        return temp->value.load();
+    }
+
+    V getOrDefault(const K& key, const V& value) const {
+        EpochGuard guard(epochs);
+
+        split_node<K, V>* temp = findNode(key);
+
+        return temp ? temp->value.load() : value;
+    }
+
+    bool tryGet(const K& key, V& out) const {
+        EpochGuard guard(epochs);
+
+        split_node<K, V>* temp = findNode(key);
+
+        if (!temp) return false;
+
+        out = temp->value.load();
+        return true;
+    }
+
+    bool containsKey(const K& key) const {
+        EpochGuard guard(epochs);
+
+        return findNode(key) != nullptr;
+    }
+
+    // marking the entry is the removal; unlinking it is cleanup that any thread may finish
+    void remove(const K& key) {
+        EpochGuard guard(epochs);
+
+        std::size_t h = hasher(key);
+        split_link* start = bucketFor(h);
+        std::atomic<std::uintptr_t>* prev;
+        split_link* cur;
+
+        while (true) {
+            if (!search(start, entryOrder(h), &key, prev, cur)) throw std::out_of_range("Key not found");
+
+            std::uintptr_t next = cur->next.load(std::memory_order_acquire);
+
+            if (next & 1) continue;
+
+            if (!cur->next.compare_exchange_strong(next, next | 1, std::memory_order_acq_rel, std::memory_order_relaxed)) continue;
+
+            std::uintptr_t expected = word(cur);
+
+            if (prev->compare_exchange_strong(expected, next, std::memory_order_release, std::memory_order_relaxed)) {
+                epochs.retire(static_cast<split_node<K, V>*>(cur));
+            } else {
+                // the list changed around cur; a fresh search unlinks it
+                search(start, entryOrder(h), &key, prev, cur);
+            }
+
+            break;
+        }
+
+        count(-1);
+    }
+
+    // exact once writers are quiescent, approximate while they run
+    int size() const {
+        long long total = published.load(std::memory_order_relaxed);
+
+        for (int i = 0; i < MAX_EPOCH_THREADS; i++) total += pending[i].value.load(std::memory_order_relaxed);
+
+        return static_cast<int>(total);
+    }
+
+    bool isEmpty() const { return size() == 0; }
+
+    // current bucket count; only grows
+    int buckets() const { return static_cast<int>(bucketCount.load(std::memory_order_relaxed)); }
+
+    // removes every entry present when the sweep reaches it; entries inserted concurrently may stay
+    void clear() {
+        EpochGuard guard(epochs);
+
+        long long removed {0};
+        split_link* cur = link(head->next.load(std::memory_order_acquire));
+
+        while (cur) {
+            std::uintptr_t next = cur->next.load(std::memory_order_acquire);
+
+            // a failed mark means a new successor: look at the same link again
+            if ((cur->order & 1) && !(next & 1)) {
+                if (!cur->next.compare_exchange_strong(next, next | 1, std::memory_order_acq_rel, std::memory_order_relaxed)) continue;
+
+                removed++;
+            }
+
+            cur = link(next);
+        }
+
+        // one sweep past the largest key unlinks everything marked
+        std::atomic<std::uintptr_t>* prev;
+        search(head, ~static_cast<std::uint64_t>(0), nullptr, prev, cur);
+
+        count(-removed);
+    }
+};
+
+#endif
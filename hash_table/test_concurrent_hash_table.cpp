@@ -0,0 +1,109 @@
+#include "concurrent_hash_table.h"
+#include <cassert>
+#include <string>
+#include <thread>
+#include <iostream>
+
+
+constexpr int ELEMENTS {100'000};
+constexpr int THREADS {8};
+
+
+int main() {
+    // Test 1: constructor
+    ConcurrentHashTable<std::string, int> ht;
+    assert(ht.isEmpty());
+    assert(ht.size() == 0);
+    assert(ht.shardCount() == DEFAULT_SHARD_COUNT);
+
+    ConcurrentHashTable<int, int> odd{5};
+    assert(odd.shardCount() == 8);
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: basic operations
+    ht.put("one", 1);
+    ht.put("two", 2);
+    ht.put("three", 3);
+    ht.put("one", 11);
+    assert(ht.get("one") == 11);
+    assert(ht.containsKey("two"));
+    assert(!ht.containsKey("four"));
+    assert(ht.containsValue(3));
+    assert(!ht.containsValue(1));
+    assert(ht.getOrDefault("four", 4) == 4);
+    assert(ht.size() == 3);
+
+    ht.remove("two");
+    assert(!ht.containsKey("two"));
+    assert(ht.size() == 2);
+
+    ht.clear();
+    assert(ht.isEmpty());
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: concurrent writers on disjoint key ranges
+    ConcurrentHashTable<int, int> shared;
+    std::thread writers[THREADS];
+
+    for (int t = 0; t < THREADS; t++) {
+        writers[t] = std::thread([&shared, t]() {
+            for (int i = t; i < ELEMENTS; i += THREADS) shared.put(i, i * 2);
+        });
+    }
+
+    for (int t = 0; t < THREADS; t++) writers[t].join();
+
+    assert(shared.size() == ELEMENTS);
+    for (int i = 0; i < ELEMENTS; i++) assert(shared.get(i) == i * 2);
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: concurrent readers alongside a remover
+    std::thread readers[THREADS];
+    bool ok[THREADS];
+
+    for (int t = 0; t < THREADS; t++) {
+        readers[t] = std::thread([&shared, &ok, t]() {
+            ok[t] = true;
+
+            // odd keys are never removed
+            for (int i = 1; i < ELEMENTS; i += 2) {
+                if (shared.getOrDefault(i, -1) != i * 2) ok[t] = false;
+            }
+        });
+    }
+
+    for (int i = 0; i < ELEMENTS; i += 2) shared.remove(i);
+
+    for (int t = 0; t < THREADS; t++) {
+        readers[t].join();
+        assert(ok[t]);
+    }
+
+    assert(shared.size() == ELEMENTS / 2);
+
+    std::cout << "Test 4 passed\n";
+
+    // Test 5: copy constructor and assignment
+    ConcurrentHashTable<int, int> copy{shared};
+    assert(copy.size() == ELEMENTS / 2);
+    assert(copy.get(1) == 2);
+
+    ConcurrentHashTable<int, int> assigned{4};
+    assigned.put(-1, -1);
+    assigned = shared;
+    assert(assigned.shardCount() == shared.shardCount());
+    assert(!assigned.containsKey(-1));
+    assert(assigned.get(3) == 6);
+
+    assigned = assigned;
+    assert(assigned.size() == ELEMENTS / 2);
+
+    std::cout << "Test 5 passed\n";
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "epoch_hash_table.h"
+#include <cassert>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <iostream>
+
+
+constexpr int ELEMENTS {100'000};
+constexpr int READERS {4};
+
+
+int main() {
+    // Test 1: constructor
+    EpochHashTable<std::string, int> ht;
+    assert(ht.isEmpty());
+    assert(ht.size() == 0);
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: basic operations
+    ht.put("one", 1);
+    ht.put("two", 2);
+    ht.put("three", 3);
+    ht.put("one", 11);
+    assert(ht.get("one") == 11);
+    assert(ht.containsKey("two"));
+    assert(!ht.containsKey("four"));
+    assert(ht.getOrDefault("four", 4) == 4);
+    assert(ht.size() == 3);
+
+    ht.remove("two");
+    assert(!ht.containsKey("two"));
+    assert(ht.size() == 2);
+
+    bool thrown {false};
+    try {
+        ht.get("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    ht.clear();
+    assert(ht.isEmpty());
+    assert(!ht.containsKey("one"));
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: stress testing (expand/shrink)
+    EpochHashTable<int, double> stress_ht{2};
+
+    for (int i = 0; i < ELEMENTS; i++) stress_ht.put(i, static_cast<double>(i));
+
+    assert(stress_ht.size() == ELEMENTS);
+
+    for (int i = 0; i < ELEMENTS; i++) stress_ht.remove(i);
+
+    assert(stress_ht.isEmpty());
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: lock-free readers while a writer updates, removes and resizes
+    EpochHashTable<int, int> shared;
+
+    // even keys are stable, odd keys churn
+    for (int i = 0; i < ELEMENTS; i += 2) shared.put(i, i);
+
+    std::atomic<bool> done {false};
+    std::thread readers[READERS];
+    bool ok[READERS];
+
+    for (int t = 0; t < READERS; t++) {
+        readers[t] = std::thread([&shared, &done, &ok, t]() {
+            ok[t] = true;
+
+            while (!done.load()) {
+                for (int i = 0; i < ELEMENTS; i += 2) {
+                    if (shared.getOrDefault(i, -1) != i) ok[t] = false;
+                }
+            }
+        });
+    }
+
+    for (int round = 0; round < 4; round++) {
+        for (int i = 1; i < ELEMENTS; i += 2) shared.put(i, i);
+        for (int i = 0; i < ELEMENTS; i += 2) shared.put(i, i);
+        for (int i = 1; i < ELEMENTS; i += 2) shared.remove(i);
+    }
+
+    done.store(true);
+
+    for (int t = 0; t < READERS; t++) {
+        readers[t].join();
+        assert(ok[t]);
+    }
+
+    assert(shared.size() == ELEMENTS / 2);
+
+    std::cout << "Test 4 passed\n";
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "fixed_hash_table.h"
+#include <cassert>
+#include <string>
+#include <iostream>
+
+
+constexpr int ELEMENTS {100'000};
+
+
+int main() {
+    // Test 1: constructor
+    FixedHashTable<std::string, int, 8> ht;
+    assert(ht.isEmpty());
+    assert(ht.size() == 0);
+    assert(!ht.isFull());
+    static_assert(FixedHashTable<std::string, int, 8>::capacity() == 8);
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: basic operations
+    assert(ht.put("one", 1));
+    assert(ht.put("two", 2));
+    assert(ht.put("three", 3));
+    assert(ht.get("one") == 1);
+    assert(ht.get("two") == 2);
+    assert(ht.containsKey("three"));
+    assert(!ht.containsKey("four"));
+    assert(ht.containsValue(2));
+    assert(!ht.containsValue(5));
+    assert(ht.size() == 3);
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: duplicate keys and non-throwing lookups
+    assert(ht.put("one", 11));
+    assert(ht.get("one") == 11);
+    assert(ht.size() == 3);
+    assert(ht.getOrDefault("four", 4) == 4);
+    assert(ht.find("two") && *ht.find("two") == 2);
+    assert(ht.find("four") == nullptr);
+
+    int out {0};
+    assert(ht.tryGet("three", out) && out == 3);
+    assert(!ht.tryGet("four", out) && out == 3);
+
+    bool thrown {false};
+
+    try {
+        ht.get("four");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: full table reports failure instead of growing
+    for (int i = 0; i < 5; i++) assert(ht.put("k" + std::to_string(i), i));
+
+    assert(ht.isFull());
+    assert(!ht.put("overflow", 0));
+    assert(!ht.containsKey("overflow"));
+    assert(ht.size() == 8);
+
+    // overwriting still works when full
+    assert(ht.put("k0", 100));
+    assert(ht.get("k0") == 100);
+
+    std::cout << "Test 4 passed\n";
+
+    // Test 5: remove frees a slot for reuse
+    ht.remove("two");
+    assert(!ht.containsKey("two"));
+    assert(!ht.isFull());
+    assert(ht.put("overflow", 0));
+    assert(ht.isFull());
+
+    thrown = false;
+
+    try {
+        ht.remove("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    std::cout << "Test 5 passed\n";
+
+    // Test 6: copy and assignment
+    FixedHashTable<std::string, int, 8> copy(ht);
+    assert(copy.size() == 8);
+    assert(copy.get("overflow") == 0);
+
+    copy.remove("one");
+    assert(ht.containsKey("one"));
+
+    FixedHashTable<std::string, int, 8> assigned;
+    assigned.put("x", 1);
+    assigned = ht;
+    assert(assigned.size() == 8);
+    assert(!assigned.containsKey("x"));
+    assert(assigned.get("k0") == 100);
+
+    assigned = assigned;
+    assert(assigned.size() == 8);
+
+    std::cout << "Test 6 passed\n";
+
+    // Test 7: clear
+    ht.clear();
+    assert(ht.isEmpty());
+    assert(!ht.containsKey("one"));
+    assert(ht.put("one", 1));
+
+    std::cout << "Test 7 passed\n";
+
+    // Test 8: non power-of-two capacity
+    FixedHashTable<int, int, 100> odd;
+
+    for (int i = 0; i < 100; i++) assert(odd.put(i * 31, i));
+
+    assert(!odd.put(-1, 0));
+
+    for (int i = 0; i < 100; i++) assert(odd.get(i * 31) == i);
+
+    std::cout << "Test 8 passed\n";
+
+    // Test 9: stress with churn in a table that lives on the stack
+    FixedHashTable<int, int, 1024> stress;
+
+    for (int round = 0; round < ELEMENTS / 1024; round++) {
+        for (int i = 0; i < 1024; i++) assert(stress.put(round * 1024 + i, i));
+
+        assert(stress.isFull());
+
+        for (int i = 0; i < 1024; i++) {
+            assert(stress.get(round * 1024 + i) == i);
+            stress.remove(round * 1024 + i);
+        }
+
+        assert(stress.isEmpty());
+    }
+
+    std::cout << "Test 9 passed\n";
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "flat_hash_table.h"
+#include <cassert>
+#include <string>
+#include <iostream>
+
+
+constexpr int ELEMENTS {1'000'000};
+
+
+// counts copies, so tests can tell a copy from a move
+struct Counted {
+    static int copies;
+    int id;
+
+    explicit Counted(int i = 0) : id(i) {}
+    Counted(const Counted& other) : id(other.id) { copies++; }
+    Counted(Counted&& other) noexcept : id(other.id) {}
+    Counted& operator=(const Counted& other) { id = other.id; copies++; return *this; }
+};
+
+int Counted::copies {0};
+
+
+int main() {
+    // Test 1: constructor
+    FlatHashTable<std::string, int> ht;
+    assert(ht.isEmpty());
+    assert(ht.size() == 0);
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: basic operations
+    ht.put("one", 1);
+    ht.put("two", 2);
+    ht.put("three", 3);
+    assert(ht.get("one") == 1);
+    assert(ht.get("two") == 2);
+    assert(ht.containsKey("one"));
+    assert(ht.containsKey("three"));
+    assert(!ht.containsKey("four"));
+    assert(ht.containsValue(2));
+    assert(!ht.containsValue(5));
+    assert(ht.size() == 3);
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: duplicate keys and getOrDefault
+    ht.put("one", 11);
+    assert(ht.get("one") == 11);
+    assert(!ht.containsValue(1));
+    assert(ht.size() == 3);
+    assert(ht.getOrDefault("four", 4) == 4);
+    assert(ht.getOrDefault("one", 4) == 11);
+    assert(!ht.containsKey("four"));
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: remove/clear
+    ht.remove("two");
+    assert(!ht.containsKey("two"));
+    assert(ht.size() == 2);
+
+    bool thrown {false};
+    try {
+        ht.remove("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    ht.clear();
+    assert(ht.isEmpty());
+    assert(!ht.containsKey("one"));
+
+    std::cout << "Test 4 passed\n";
+
+    // Test 5: stress testing (expand/shrink)
+    FlatHashTable<int, double> stress_ht{2};
+
+    for (int i = 0; i < ELEMENTS; i++) stress_ht.put(i, static_cast<double>(i));
+
+    assert(stress_ht.size() == ELEMENTS);
+
+    for (int i = 0; i < ELEMENTS; i += 2) stress_ht.remove(i);
+
+    for (int i = 0; i < ELEMENTS; i++) assert(stress_ht.containsKey(i) == (i % 2 == 1));
+
+    for (int i = 1; i < ELEMENTS; i += 2) stress_ht.remove(i);
+
+    assert(stress_ht.isEmpty());
+
+    std::cout << "Test 5 passed\n";
+
+    // Test 6: tombstone churn on a fixed key window
+    FlatHashTable<int, int> churn;
+
+    for (int i = 0; i < ELEMENTS; i++) {
+        churn.put(i, i);
+        if (i >= 100) churn.remove(i - 100);
+    }
+
+    assert(churn.size() == 100);
+    assert(churn.get(ELEMENTS - 1) == ELEMENTS - 1);
+    assert(!churn.containsKey(ELEMENTS - 101));
+
+    std::cout << "Test 6 passed\n";
+
+    // Test 7: copy constructor
+    FlatHashTable<int, double> ht1;
+    ht1.put(1, 1.0);
+    ht1.put(2, 2.0);
+    ht1.put(3, 3.0);
+
+    FlatHashTable<int, double> ht2{ht1};
+    assert(ht2.size() == 3);
+    assert(ht2.get(1) == 1.0);
+    assert(ht2.containsValue(3.0));
+
+    ht1.remove(1);
+    assert(ht2.containsKey(1));
+
+    std::cout << "Test 7 passed\n";
+
+    // Test 8: assignment operator (including self-assignment)
+    FlatHashTable<int, double> ht3;
+    ht3.put(4, 4.0);
+
+    ht3 = ht2;
+    assert(ht3.size() == 3);
+    assert(!ht3.containsKey(4));
+    assert(ht3.get(2) == 2.0);
+
+    ht3 = ht3;
+    assert(ht3.size() == 3);
+    assert(ht3.get(3) == 3.0);
+
+    std::cout << "Test 8 passed\n";
+
+    // Test 9: growing moves the entries instead of copying them
+    FlatHashTable<std::string, Counted> moved;
+
+    for (int i = 0; i < 10'000; i++) moved.put(std::to_string(i), Counted(i));
+
+    // one copy per put, none for the rehashes in between
+    assert(Counted::copies == 10'000);
+
+    for (int i = 0; i < 10'000; i++) assert(moved.get(std::to_string(i)).id == i);
+
+    std::cout << "Test 9 passed\n";
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}
@@ -1,9 +1,29 @@
 #include "hash_table.h"
 #include <cassert>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <sstream>
 #include <iostream>
 
 
+// counts deep copies so tests can check that rvalues are moved
+struct tracked {
+    static int copies;
+    int v;
+
+    tracked(int x = 0) : v(x) {}
+    tracked(const tracked& other) : v(other.v) { copies++; }
+    tracked(tracked&& other) noexcept : v(other.v) {}
+    tracked& operator=(const tracked& other) { v = other.v; copies++; return *this; }
+    tracked& operator=(tracked&& other) noexcept { v = other.v; return *this; }
+    bool operator==(const tracked& other) const { return v == other.v; }
+};
+
+int tracked::copies {0};
+
+
 constexpr int ELEMENTS {1'000'000};
 
 
@@ -318,6 +338,517 @@ int main() {
 
     std::cout << "Test 22 passed\n";
 
+    // Test 23: incremental rehash (expand/shrink)
+    HashTable<int, double> inc_ht{2};
+    inc_ht.setIncrementalRehash(true);
+
+    bool sawRehash {false};
+
+    for (int i = 0; i < ELEMENTS; i++) {
+        inc_ht.put(i, static_cast<double>(i));
+        if (inc_ht.isRehashing()) sawRehash = true;
+    }
+
+    assert(sawRehash);
+    assert(inc_ht.size() == ELEMENTS);
+
+    for (int i = 0; i < ELEMENTS; i++) assert(inc_ht.get(i) == static_cast<double>(i));
+
+    for (int i = 0; i < ELEMENTS; i += 2) inc_ht.remove(i);
+
+    for (int i = 0; i < ELEMENTS; i++) assert(inc_ht.containsKey(i) == (i % 2 == 1));
+
+    for (int i = 1; i < ELEMENTS; i += 2) inc_ht.remove(i);
+
+    assert(inc_ht.isEmpty());
+
+    std::cout << "Test 23 passed\n";
+
+    // Test 24: copy/assign while a rehash is in progress
+    HashTable<int, double> inc_ht1;
+    inc_ht1.setIncrementalRehash(true);
+
+    for (int i = 0; i < 13; i++) inc_ht1.put(i, static_cast<double>(i));
+    inc_ht1.put(13, 13.0);
+    assert(inc_ht1.isRehashing());
+
+    HashTable<int, double> inc_ht2{inc_ht1};
+    HashTable<int, double> inc_ht3;
+    inc_ht3 = inc_ht1;
+
+    for (int i = 0; i < 14; i++) {
+        assert(inc_ht2.get(i) == static_cast<double>(i));
+        assert(inc_ht3.get(i) == static_cast<double>(i));
+    }
+
+    assert(inc_ht2.containsValue(13.0));
+
+    inc_ht1.setIncrementalRehash(false);
+    assert(!inc_ht1.isRehashing());
+    assert(inc_ht1.size() == 14);
+
+    std::cout << "Test 24 passed\n";
+
+    // Test 25: hash policies and non power-of-two starting capacity
+    HashTable<long long, int, StdHash<long long>> identity_ht{3};
+    HashTable<long long, int> mixed_ht{3};
+
+    for (int i = 0; i < 1000; i++) {
+        identity_ht.put(static_cast<long long>(i) << 32, i);
+        mixed_ht.put(static_cast<long long>(i) << 32, i);
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        assert(identity_ht.get(static_cast<long long>(i) << 32) == i);
+        assert(mixed_ht.get(static_cast<long long>(i) << 32) == i);
+    }
+
+    StringHash stringHash;
+    assert(stringHash(std::string("session")) == stringHash("session"));
+    assert(stringHash(std::string("session")) != stringHash("sessions"));
+    assert(IntegerHash<int>()(1) != IntegerHash<int>()(2));
+
+    std::cout << "Test 25 passed\n";
+
+    // Test 26: move-aware insertion
+    HashTable<std::string, tracked> moves;
+    tracked::copies = 0;
+
+    moves.put(std::string("a"), tracked(1));
+    moves.put("b", tracked(2));
+    moves.put("a", tracked(3));
+    assert(tracked::copies == 0);
+    assert(moves.get("a").v == 3);
+
+    tracked t4(4);
+    moves.put("c", t4);
+    assert(tracked::copies == 1);
+
+    std::cout << "Test 26 passed\n";
+
+    // Test 27: emplace/tryEmplace
+    HashTable<std::string, std::vector<int>> vectors;
+
+    assert(vectors.emplace("five", 5, 1));
+    assert(vectors.get("five").size() == 5);
+    assert(!vectors.emplace("five", 2, 2));
+    assert(vectors.get("five").size() == 5);
+
+    assert(vectors.tryEmplace("three", 3, 7));
+    assert(!vectors.tryEmplace("three", 1, 1));
+    assert(vectors.get("three")[2] == 7);
+    assert(vectors.tryEmplace("empty"));
+    assert(vectors.get("empty").empty());
+    assert(vectors.size() == 3);
+
+    std::cout << "Test 27 passed\n";
+
+    // Test 28: transparent lookups with string_view and C strings
+    std::string_view view {"three-and-more", 5};
+    assert(vectors.containsKey(view));
+    assert(vectors.get(view)[0] == 7);
+    assert(vectors.containsKey("five"));
+
+    vectors.remove(view);
+    assert(!vectors.containsKey("three"));
+    assert(vectors.size() == 2);
+
+    // non-transparent policies convert the argument to K first
+    HashTable<long long, int> widened;
+    widened.put(7, 70);
+    assert(widened.get(7) == 70);
+    assert(widened.containsKey(7));
+
+    std::cout << "Test 28 passed\n";
+
+    // Test 29: non-throwing lookups
+    HashTable<std::string, int> lookups;
+    lookups.put("hit", 1);
+
+    assert(lookups.find("hit") && *lookups.find("hit") == 1);
+    assert(lookups.find("miss") == nullptr);
+
+    *lookups.find("hit") = 2;
+    assert(lookups.get("hit") == 2);
+
+    int out {0};
+    assert(lookups.tryGet("hit", out) && out == 2);
+    assert(!lookups.tryGet("miss", out) && out == 2);
+
+    assert(lookups.getOrDefault("miss", -1) == -1);
+    assert(lookups.getOrDefault("hit", -1) == 2);
+
+    const HashTable<std::string, int>& constLookups = lookups;
+    assert(*constLookups.find("hit") == 2);
+
+    std::cout << "Test 29 passed\n";
+
+    // Test 30: batch operations
+    HashTable<int, int> batch;
+    int batchKeys[100];
+    int batchValues[100];
+
+    for (int i = 0; i < 100; i++) {
+        batchKeys[i] = i % 60;
+        batchValues[i] = i;
+    }
+
+    batch.putMany(batchKeys, batchValues, 100);
+    assert(batch.size() == 60);
+    assert(batch.get(0) == 60);
+    assert(batch.get(59) == 59);
+
+    int probes[50];
+    const int* values[50];
+    bool present[50];
+
+    for (int i = 0; i < 50; i++) probes[i] = i * 2;
+
+    assert(batch.getMany(probes, 50, values) == 30);
+    assert(batch.containsMany(probes, 50, present) == 30);
+
+    for (int i = 0; i < 50; i++) {
+        assert(present[i] == (probes[i] < 60));
+        assert((values[i] != nullptr) == present[i]);
+        if (values[i]) assert(*values[i] == batch.get(probes[i]));
+    }
+
+    // heterogeneous keys and incremental mode
+    HashTable<std::string, int> batchStrings;
+    batchStrings.setIncrementalRehash(true);
+
+    std::string words[40];
+    int wordValues[40];
+
+    for (int i = 0; i < 40; i++) {
+        words[i] = "word" + std::to_string(i);
+        wordValues[i] = i;
+    }
+
+    batchStrings.putMany(words, wordValues, 40);
+
+    const char* names[3] {"word1", "word39", "word40"};
+    bool namePresent[3];
+    assert(batchStrings.containsMany(names, 3, namePresent) == 2);
+    assert(namePresent[0] && namePresent[1] && !namePresent[2]);
+
+    std::cout << "Test 30 passed\n";
+
+    // Test 31: forEach visits every entry once, including during an incremental rehash
+    HashTable<int, int> visited;
+    visited.setIncrementalRehash(true);
+
+    for (int i = 0; i < 100; i++) visited.put(i, i);
+
+    assert(visited.isRehashing());
+
+    long long keySum {0};
+    int visits {0};
+
+    visited.forEach([&](const int& key, const int& value) {
+        assert(key == value);
+        keySum += key;
+        visits++;
+    });
+
+    assert(visits == 100);
+    assert(keySum == 99 * 100 / 2);
+
+    std::cout << "Test 31 passed\n";
+
+    // Test 32: reserve
+    HashTable<int, int> reserved;
+    reserved.reserve(1000);
+
+    for (int i = 0; i < 1000; i++) reserved.put(i, i);
+
+    assert(reserved.size() == 1000);
+    assert(reserved.get(999) == 999);
+
+    // shrinking requests are ignored, existing entries stay
+    reserved.reserve(10);
+    assert(reserved.size() == 1000);
+    assert(reserved.get(0) == 0);
+
+    bool reserveThrown {false};
+
+    try {
+        reserved.reserve(-1);
+    } catch (const std::invalid_argument&) {
+        reserveThrown = true;
+    }
+
+    assert(reserveThrown);
+
+    // finishes a pending incremental rehash first
+    HashTable<int, int> reservedIncremental;
+    reservedIncremental.setIncrementalRehash(true);
+
+    for (int i = 0; i < 100; i++) reservedIncremental.put(i, i);
+
+    assert(reservedIncremental.isRehashing());
+
+    reservedIncremental.reserve(5000);
+    assert(!reservedIncremental.isRehashing());
+
+    for (int i = 0; i < 100; i++) assert(reservedIncremental.get(i) == i);
+
+    std::cout << "Test 32 passed\n";
+
+    // Test 33: bulk constructor
+    std::vector<std::pair<int, int>> pairs;
+
+    for (int i = 0; i < ELEMENTS; i++) pairs.push_back({i, i * 3});
+
+    for (int threads = 1; threads <= 4; threads++) {
+        HashTable<int, int> bulk(pairs.begin(), pairs.end(), threads);
+        assert(bulk.size() == ELEMENTS);
+
+        for (int i = 0; i < ELEMENTS; i++) assert(bulk.get(i) == i * 3);
+
+        assert(!bulk.containsKey(ELEMENTS));
+
+        // the table behaves normally afterwards
+        bulk.remove(0);
+        bulk.put(-1, -1);
+        assert(bulk.size() == ELEMENTS);
+    }
+
+    // duplicates: the last pair wins, like repeated put
+    std::pair<std::string, int> wordPairs[5] {{"a", 1}, {"b", 2}, {"a", 3}, {"c", 4}, {"a", 5}};
+    HashTable<std::string, int> bulkWords(wordPairs, wordPairs + 5, 2);
+    assert(bulkWords.size() == 3);
+    assert(bulkWords.get("a") == 5);
+    assert(bulkWords.get("b") == 2);
+
+    bulkWords.put("d", 6);
+    assert(bulkWords.size() == 4);
+
+    // empty range and non-random-access ranges
+    HashTable<int, int> bulkEmpty(pairs.begin(), pairs.begin());
+    assert(bulkEmpty.isEmpty());
+
+    std::map<int, int> ordered {{1, 10}, {2, 20}, {3, 30}};
+    HashTable<int, int> bulkMap(ordered.begin(), ordered.end());
+    assert(bulkMap.size() == 3);
+    assert(bulkMap.get(2) == 20);
+
+    std::cout << "Test 33 passed\n";
+
+    // Test 34: membership filters never hide a key
+    MembershipFilter filterTypes[2] {MembershipFilter::BLOOM, MembershipFilter::CUCKOO};
+
+    for (MembershipFilter type : filterTypes) {
+        for (int incremental = 0; incremental < 2; incremental++) {
+            HashTable<int, int> filtered;
+            filtered.setIncrementalRehash(incremental);
+            filtered.setMembershipFilter(type);
+
+            for (int i = 0; i < 100'000; i++) filtered.put(i, i);
+
+            for (int i = 0; i < 100'000; i++) assert(filtered.get(i) == i);
+
+            for (int i = 100'000; i < 200'000; i++) assert(!filtered.containsKey(i));
+
+            // removals and shrinking, with a resize that may still be draining
+            for (int i = 0; i < 100'000; i += 2) filtered.remove(i);
+
+            for (int i = 0; i < 100'000; i++) assert(filtered.containsKey(i) == (i % 2 == 1));
+
+            for (int i = 0; i < 90'000; i++) {
+                if (i % 2 == 1) filtered.remove(i);
+            }
+
+            for (int i = 90'000; i < 100'000; i++) assert(filtered.getOrDefault(i, -1) == (i % 2 == 1 ? i : -1));
+
+            // re-inserting removed keys
+            for (int i = 0; i < 1000; i++) filtered.put(i, -i);
+
+            for (int i = 0; i < 1000; i++) assert(filtered.get(i) == -i);
+
+            FilterStats stats = filtered.filterStats();
+            assert(stats.type == type);
+            assert(stats.bytes > 0);
+            assert(!stats.saturated);
+            assert(stats.falsePositiveRate < 0.05);
+
+            // copies and clear keep the filter type
+            HashTable<int, int> filteredCopy(filtered);
+            assert(filteredCopy.filterStats().type == type);
+
+            for (int i = 0; i < 1000; i++) assert(filteredCopy.get(i) == -i);
+
+            filtered.clear();
+            assert(!filtered.containsKey(5));
+            filtered.put(5, 5);
+            assert(filtered.get(5) == 5);
+        }
+    }
+
+    HashTable<std::string, int> filteredStrings;
+    filteredStrings.setMembershipFilter(MembershipFilter::CUCKOO);
+    filteredStrings.put("apple", 1);
+    assert(filteredStrings.containsKey(std::string_view("apple")));
+    assert(!filteredStrings.containsKey("pear"));
+
+    filteredStrings.setMembershipFilter(MembershipFilter::NONE);
+    assert(filteredStrings.filterStats().type == MembershipFilter::NONE);
+    assert(filteredStrings.get("apple") == 1);
+
+    std::cout << "Test 34 passed\n";
+
+    // Test 35: value index
+    HashTable<int, std::string> indexed;
+    indexed.put(1, "a");
+    indexed.put(2, "b");
+    indexed.put(3, "a");
+
+    indexed.setValueIndex(true);
+    assert(indexed.hasValueIndex());
+    assert(indexed.containsValue("a"));
+    assert(indexed.containsValue("b"));
+    assert(!indexed.containsValue("c"));
+
+    // two keys hold "a": it stays until both are gone
+    indexed.remove(1);
+    assert(indexed.containsValue("a"));
+    indexed.put(3, "c");
+    assert(!indexed.containsValue("a"));
+    assert(indexed.containsValue("c"));
+
+    indexed.emplace(4, 3, 'x');
+    indexed.tryEmplace(5, "y");
+    int indexedKeys[2] {6, 2};
+    std::string indexedValues[2] {"z", "w"};
+    indexed.putMany(indexedKeys, indexedValues, 2);
+    assert(indexed.containsValue("xxx"));
+    assert(indexed.containsValue("y"));
+    assert(indexed.containsValue("z"));
+    assert(indexed.containsValue("w"));
+    assert(!indexed.containsValue("b"));
+
+    // copies carry their own index
+    HashTable<int, std::string> indexedCopy(indexed);
+    indexedCopy.remove(6);
+    assert(!indexedCopy.containsValue("z"));
+    assert(indexed.containsValue("z"));
+
+    indexed.clear();
+    assert(indexed.hasValueIndex());
+    assert(!indexed.containsValue("c"));
+    indexed.put(1, "c");
+    assert(indexed.containsValue("c"));
+
+    // agrees with a full scan through many resizes
+    HashTable<int, int> indexedInts;
+    indexedInts.setValueIndex(true);
+
+    for (int i = 0; i < 100'000; i++) indexedInts.put(i, i % 1000);
+
+    for (int i = 0; i < 100'000; i++) {
+        if (i % 1000 != 7) indexedInts.remove(i);
+    }
+
+    assert(indexedInts.containsValue(7));
+    assert(!indexedInts.containsValue(8));
+
+    indexedInts.setValueIndex(false);
+    assert(!indexedInts.hasValueIndex());
+    assert(indexedInts.containsValue(7));
+    assert(!indexedInts.containsValue(8));
+
+    std::cout << "Test 35 passed\n";
+
+    // Test 36: instrumentation
+    HashTable<int, int> measured;
+
+    for (int i = 0; i < 1000; i++) measured.put(i, i);
+
+    long long histogram[4];
+    measured.chainHistogram(histogram, 4);
+    assert(histogram[0] + histogram[1] + histogram[2] + histogram[3] == 2048);
+    assert(histogram[1] + 2 * histogram[2] <= 1000);
+    assert(measured.memoryUsage() > 1000 * sizeof(int) * 2);
+
+    std::ostringstream report;
+    measured.dumpStats(report);
+    assert(report.str().find("size: 1000") != std::string::npos);
+
+#ifdef HASH_TABLE_STATS
+    measured.get(5);
+    measured.getOrDefault(5000, 0);
+    measured.remove(7);
+    measured.put(8, 0);
+
+    HashTableStats counted = measured.stats();
+    assert(counted.reads == 2 && counted.readHits == 1);
+    assert(counted.inserts == 1000 && counted.overwrites == 1);
+    assert(counted.removes == 1);
+    assert(counted.resizes == 7);
+    assert(counted.searchProbes > 0 && counted.resizeNanos > 0);
+#endif
+
+    std::cout << "Test 36 passed\n";
+
+    // Test 37: parallel copy and assignment
+    for (int incremental = 0; incremental < 2; incremental++) {
+        HashTable<std::string, int> source;
+        source.setIncrementalRehash(incremental);
+        source.setValueIndex(true);
+
+        // 3100 entries leave an incremental table mid-rehash
+        for (int i = 0; i < 3100; i++) source.put(std::to_string(i), i % 100);
+
+        for (int threads = 1; threads <= 5; threads++) {
+            HashTable<std::string, int> cloned(source, threads);
+            assert(cloned.size() == source.size());
+            assert(cloned.hasValueIndex());
+
+            for (int i = 0; i < 3100; i++) assert(cloned.get(std::to_string(i)) == i % 100);
+
+            // the clone is independent of the source
+            cloned.remove("0");
+            cloned.put("new", 500);
+            assert(source.containsKey("0") && !source.containsKey("new"));
+            assert(cloned.containsValue(500) && !source.containsValue(500));
+
+            HashTable<std::string, int> assigned;
+            assigned.put("old", 1);
+            assigned.assign(source, threads);
+            assert(assigned.size() == source.size());
+            assert(!assigned.containsKey("old"));
+
+            for (int i = 0; i < 3100; i++) assert(assigned.get(std::to_string(i)) == i % 100);
+
+            for (int i = 0; i < 3100; i++) assigned.remove(std::to_string(i));
+
+            assert(assigned.isEmpty());
+        }
+    }
+
+    // more threads than buckets, and an empty source
+    HashTable<int, int> tiny;
+    tiny.put(1, 1);
+    HashTable<int, int> tinyCopy(tiny, 64);
+    assert(tinyCopy.get(1) == 1);
+
+    HashTable<int, int> emptyCopy(HashTable<int, int>(), 4);
+    assert(emptyCopy.isEmpty());
+
+    bool copyThrown {false};
+
+    try {
+        tinyCopy.assign(tiny, 0);
+    } catch (const std::invalid_argument&) {
+        copyThrown = true;
+    }
+
+    assert(copyThrown);
+    tinyCopy.assign(tinyCopy, 2);
+    assert(tinyCopy.get(1) == 1);
+
+    std::cout << "Test 37 passed\n";
+
     std::cout << "All tests passed successfully\n";
 
     return 0;
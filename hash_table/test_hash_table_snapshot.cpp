@@ -0,0 +1,272 @@
+#include "hash_table_snapshot.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <iostream>
+
+
+constexpr int ELEMENTS {1'000'000};
+
+
+struct point {
+    int x;
+    int y;
+
+    bool operator==(const point& other) const { return x == other.x && y == other.y; }
+};
+
+
+int main() {
+    const std::string path {"test_hash_table_snapshot.bin"};
+
+    // Test 1: round trip
+    HashTable<int, int> ht;
+
+    for (int i = 0; i < 1000; i++) ht.put(i, i * 2);
+
+    saveSnapshot(ht, path);
+
+    {
+        MappedHashTable<int, int> mapped(path);
+        assert(mapped.size() == 1000);
+        assert(!mapped.isEmpty());
+
+        for (int i = 0; i < 1000; i++) assert(mapped.get(i) == i * 2);
+
+        assert(!mapped.containsKey(1000));
+        assert(!mapped.containsKey(-1));
+    }
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: lookups on a miss
+    {
+        MappedHashTable<int, int> mapped(path);
+        int out {-1};
+
+        assert(mapped.find(5) && *mapped.find(5) == 10);
+        assert(mapped.find(3100) == nullptr);
+        assert(mapped.tryGet(7, out) && out == 14);
+        assert(!mapped.tryGet(3100, out) && out == 14);
+        assert(mapped.getOrDefault(3100, -1) == -1);
+        assert(mapped.getOrDefault(3, -1) == 6);
+
+        bool thrown {false};
+
+        try {
+            mapped.get(3100);
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+
+        assert(thrown);
+    }
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: empty table
+    HashTable<int, int> empty;
+    saveSnapshot(empty, path);
+
+    {
+        MappedHashTable<int, int> mapped(path);
+        assert(mapped.isEmpty());
+        assert(mapped.size() == 0);
+        assert(!mapped.containsKey(0));
+    }
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: struct values and saving mid-rehash
+    HashTable<long long, point> points;
+    points.setIncrementalRehash(true);
+
+    for (int i = 0; i < 3100; i++) points.put(i * 1000003LL, point {i, -i});
+
+    assert(points.isRehashing());
+
+    saveSnapshot(points, path);
+
+    {
+        MappedHashTable<long long, point> mapped(path);
+        assert(mapped.size() == 3100);
+
+        for (int i = 0; i < 3100; i++) assert((mapped.get(i * 1000003LL) == point {i, -i}));
+    }
+
+    std::cout << "Test 4 passed\n";
+
+    // Test 5: load back into a mutable table
+    {
+        MappedHashTable<long long, point> mapped(path);
+        HashTable<long long, point> loaded = mapped.load();
+        assert(loaded.size() == 3100);
+
+        loaded.put(-1, point {1, 1});
+        assert(loaded.size() == 3101);
+        assert((loaded.get(2 * 1000003LL) == point {2, -2}));
+    }
+
+    std::cout << "Test 5 passed\n";
+
+    // Test 6: rejected files
+    bool thrown {false};
+
+    try {
+        MappedHashTable<int, int> missing("does_not_exist.bin");
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    // entry size differs from the one the file was written with
+    thrown = false;
+
+    try {
+        MappedHashTable<int, int> wrongType(path);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    std::ofstream garbage(path, std::ios::binary | std::ios::trunc);
+    garbage << "definitely not a snapshot file, just some text";
+    garbage.close();
+
+    thrown = false;
+
+    try {
+        MappedHashTable<int, int> corrupt(path);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    std::cout << "Test 6 passed\n";
+
+    // Test 7: large snapshot
+    HashTable<int, int> large;
+
+    for (int i = 0; i < ELEMENTS; i++) large.put(i, i + 1);
+
+    saveSnapshot(large, path);
+
+    {
+        MappedHashTable<int, int> mapped(path);
+        assert(mapped.size() == ELEMENTS);
+
+        for (int i = 0; i < ELEMENTS; i++) assert(mapped.get(i) == i + 1);
+
+        for (int i = ELEMENTS; i < ELEMENTS + 1000; i++) assert(!mapped.containsKey(i));
+    }
+
+    std::cout << "Test 7 passed\n";
+
+    // Test 8: saving over a mapped snapshot replaces the file without touching the mapping
+    HashTable<int, int> before;
+    HashTable<int, int> after;
+
+    for (int i = 0; i < 1000; i++) {
+        before.put(i, i);
+        after.put(i + 1000, -i);
+    }
+
+    saveSnapshot(before, path);
+
+    {
+        MappedHashTable<int, int> old(path);
+
+        saveSnapshot(after, path);
+
+        MappedHashTable<int, int> current(path);
+
+        for (int i = 0; i < 1000; i++) {
+            assert(old.get(i) == i);
+            assert(current.get(i + 1000) == -i);
+            assert(!current.containsKey(i));
+        }
+    }
+
+    // a failed save throws and leaves the previous snapshot in place
+    thrown = false;
+
+    try {
+        saveSnapshot(before, "no_such_directory/" + path);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    {
+        MappedHashTable<int, int> current(path);
+        assert(current.size() == 1000);
+    }
+
+    std::ifstream leftover(path + ".tmp");
+    assert(!leftover);
+
+    std::cout << "Test 8 passed\n";
+
+    // Test 9: corrupt headers and bucket offsets are rejected before any lookup
+    saveSnapshot(before, path);
+
+    std::ifstream in(path, std::ios::binary);
+    std::string original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    snapshot_header header;
+    std::memcpy(&header, original.data(), sizeof(header));
+
+    std::size_t offsetsAt = sizeof(snapshot_header);
+    std::uint64_t huge = ~0ULL / sizeof(snapshot_entry<int, int>) + 2;
+
+    // each case patches one 64-bit field: {position, new value}
+    const std::size_t fields[][2] {
+        // a count that wraps the size arithmetic
+        {offsetof(snapshot_header, count), static_cast<std::size_t>(huge)},
+        // a bucket count whose offsets run past the end of the file
+        {offsetof(snapshot_header, bucketCount), std::size_t {1} << 40},
+        // first offset not at the start of the entries
+        {offsetsAt, 1},
+        // a bucket that ends before it starts
+        {offsetsAt + 8 * sizeof(std::uint64_t), 0},
+        // an offset past the last entry
+        {offsetsAt + 3 * sizeof(std::uint64_t), static_cast<std::size_t>(header.count) + 5},
+    };
+
+    for (const auto& field : fields) {
+        std::string patched(original);
+        std::uint64_t value = field[1];
+        std::memcpy(&patched[field[0]], &value, sizeof(value));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(patched.data(), patched.size());
+        out.close();
+
+        thrown = false;
+
+        try {
+            MappedHashTable<int, int> corrupt(path);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+
+        assert(thrown);
+    }
+
+    std::cout << "Test 9 passed\n";
+
+    std::remove(path.c_str());
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include "persistent_hash_map.h"
+#include <cassert>
+#include <string>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <iostream>
+
+
+constexpr int ELEMENTS {100'000};
+constexpr int READERS {4};
+
+
+// every key shares one full hash, so all entries end up in a collision list
+struct ConstantHash {
+    std::size_t operator()(int) const { return 0x0123456789abcdefULL; }
+};
+
+// hashes that agree on their low 40 bits, forcing long chains of one-child nodes
+struct SharedPrefixHash {
+    std::size_t operator()(int key) const { return (static_cast<std::size_t>(key) << 40) | 0xabcdef1234ULL; }
+};
+
+
+int main() {
+    // Test 1: constructor
+    PersistentHashMap<std::string, int> map;
+    assert(map.isEmpty());
+    assert(map.size() == 0);
+    assert(!map.containsKey("one"));
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: basic operations
+    map.put("one", 1);
+    map.put("two", 2);
+    map.put("three", 3);
+    map.put("one", 11);
+    assert(map.get("one") == 11);
+    assert(map.containsKey("two"));
+    assert(!map.containsKey("four"));
+    assert(map.getOrDefault("four", 4) == 4);
+    assert(*map.find("three") == 3);
+    assert(map.find("four") == nullptr);
+    assert(map.size() == 3);
+
+    int out {0};
+    assert(map.tryGet("two", out) && out == 2);
+    assert(!map.tryGet("four", out));
+
+    map.remove("two");
+    assert(!map.containsKey("two"));
+    assert(map.size() == 2);
+
+    bool thrown {false};
+    try {
+        map.get("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        map.remove("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    map.clear();
+    assert(map.isEmpty());
+    assert(!map.containsKey("one"));
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: large map, checked against std::map through inserts, updates and removes
+    PersistentHashMap<int, int> large;
+    std::map<int, int> reference;
+
+    for (int i = 0; i < ELEMENTS; i++) {
+        large.put(i * 7, i);
+        reference[i * 7] = i;
+    }
+
+    for (int i = 0; i < ELEMENTS; i += 3) {
+        large.put(i * 7, -i);
+        reference[i * 7] = -i;
+    }
+
+    for (int i = 0; i < ELEMENTS; i += 2) {
+        large.remove(i * 7);
+        reference.erase(i * 7);
+    }
+
+    assert(large.size() == static_cast<int>(reference.size()));
+
+    for (int i = 0; i < ELEMENTS * 7; i++) {
+        auto it = reference.find(i);
+        assert(large.getOrDefault(i, 1 << 30) == (it == reference.end() ? 1 << 30 : it->second));
+    }
+
+    int visited {0};
+    large.forEach([&](int key, int value) {
+        assert(reference.at(key) == value);
+        visited++;
+    });
+    assert(visited == large.size());
+
+    for (const auto& p : reference) large.remove(p.first);
+
+    assert(large.isEmpty());
+    assert(!large.containsKey(7));
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: snapshots are unaffected by later changes, and the other way round
+    PersistentHashMap<std::string, std::string> config;
+
+    for (int i = 0; i < 1000; i++) config.put("key" + std::to_string(i), "v1");
+
+    PersistentHashMap<std::string, std::string> v1 = config.snapshot();
+
+    for (int i = 0; i < 1000; i += 2) config.put("key" + std::to_string(i), "v2");
+
+    for (int i = 0; i < 1000; i += 5) config.remove("key" + std::to_string(i));
+
+    config.put("extra", "v2");
+
+    PersistentHashMap<std::string, std::string> v2(config);
+
+    assert(v1.size() == 1000);
+
+    for (int i = 0; i < 1000; i++) assert(v1.get("key" + std::to_string(i)) == "v1");
+
+    assert(!v1.containsKey("extra"));
+
+    // changing an old version leaves the newer ones alone
+    v1.put("key1", "changed");
+    v1.remove("key3");
+    assert(v2.get("key1") == "v1");
+    assert(v2.get("key3") == "v1");
+    assert(v2.get("key2") == "v2");
+    assert(!v2.containsKey("key0"));
+    assert(v2.size() == 1000 - 200 + 1);
+
+    // assignment shares too
+    PersistentHashMap<std::string, std::string> v3;
+    v3.put("gone", "x");
+    v3 = v2;
+    assert(!v3.containsKey("gone"));
+    v3 = v3;
+    assert(v3.size() == v2.size());
+
+    v2.clear();
+    assert(v3.get("extra") == "v2");
+    assert(config.get("extra") == "v2");
+
+    std::cout << "Test 4 passed\n";
+
+    // Test 5: many versions, each one put apart
+    PersistentHashMap<int, int> versions[100];
+
+    for (int i = 1; i < 100; i++) {
+        versions[i] = versions[i - 1];
+        versions[i].put(i, i);
+    }
+
+    for (int i = 0; i < 100; i++) {
+        assert(versions[i].size() == i);
+        assert(!versions[i].containsKey(i + 1));
+
+        if (i > 0) assert(versions[i].get(i) == i);
+    }
+
+    std::cout << "Test 5 passed\n";
+
+    // Test 6: full-hash collisions and long shared prefixes
+    PersistentHashMap<int, int, ConstantHash> colliding;
+
+    for (int i = 0; i < 50; i++) colliding.put(i, i);
+
+    PersistentHashMap<int, int, ConstantHash> collidingSnapshot = colliding;
+
+    for (int i = 0; i < 50; i += 2) colliding.remove(i);
+
+    colliding.put(1, -1);
+
+    for (int i = 0; i < 50; i++) {
+        assert(colliding.getOrDefault(i, 100) == (i % 2 == 0 ? 100 : (i == 1 ? -1 : i)));
+        assert(collidingSnapshot.get(i) == i);
+    }
+
+    for (int i = 1; i < 50; i += 2) colliding.remove(i);
+
+    assert(colliding.isEmpty());
+
+    PersistentHashMap<int, int, SharedPrefixHash> deep;
+
+    for (int i = 0; i < 1000; i++) deep.put(i, i);
+
+    for (int i = 0; i < 1000; i++) {
+        if (i % 10 != 0) deep.remove(i);
+    }
+
+    assert(deep.size() == 100);
+
+    for (int i = 0; i < 1000; i++) assert(deep.containsKey(i) == (i % 10 == 0));
+
+    std::cout << "Test 6 passed\n";
+
+    // Test 7: readers work on snapshots in other threads while the writer keeps changing its map
+    PersistentHashMap<int, int> live;
+
+    for (int i = 0; i < ELEMENTS; i++) live.put(i, 0);
+
+    std::thread readers[READERS];
+    bool ok[READERS];
+    std::atomic<bool> done {false};
+    PersistentHashMap<int, int> published[READERS];
+
+    for (int t = 0; t < READERS; t++) published[t] = live.snapshot();
+
+    for (int t = 0; t < READERS; t++) {
+        readers[t] = std::thread([&published, &ok, &done, t]() {
+            ok[t] = true;
+            PersistentHashMap<int, int> view = published[t];
+
+            while (!done.load()) {
+                for (int i = 0; i < ELEMENTS; i += 97) {
+                    if (view.get(i) != 0) ok[t] = false;
+                }
+            }
+
+            // dropping the last reference to shared nodes from this thread
+            view.clear();
+        });
+    }
+
+    for (int round = 1; round <= 5; round++) {
+        for (int i = 0; i < ELEMENTS; i++) live.put(i, round);
+    }
+
+    done.store(true);
+
+    for (int t = 0; t < READERS; t++) {
+        readers[t].join();
+        assert(ok[t]);
+        published[t].clear();
+    }
+
+    for (int i = 0; i < ELEMENTS; i++) assert(live.get(i) == 5);
+
+    std::cout << "Test 7 passed\n";
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}
@@ -0,0 +1,287 @@
+#include "split_ordered_hash_table.h"
+#include <cassert>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <iostream>
+
+
+constexpr int ELEMENTS {100'000};
+constexpr int THREADS {8};
+
+
+// every key in one bucket and one split-order position, so entries differ only by key
+struct ConstantHash {
+    std::size_t operator()(int) const { return 42; }
+};
+
+
+// out-of-line value whose destructor poisons it, so a reader that gets hold of a freed value
+// sees the poison (and ASan reports the read)
+struct Poisoned {
+    long long key;
+    long long check;
+    long long pad;
+
+    Poisoned() : key(0), check(0), pad(0) {}
+    explicit Poisoned(long long k) : key(k), check(k ^ 0x5a5a5a5a), pad(0) {}
+    ~Poisoned() { check = -1; }
+
+    bool valid() const { return check == (key ^ 0x5a5a5a5a); }
+};
+
+
+int main() {
+    // Test 1: constructor
+    SplitOrderedHashTable<std::string, int> ht;
+    assert(ht.isEmpty());
+    assert(ht.size() == 0);
+    assert(ht.buckets() == SPLIT_DEFAULT_CAPACITY);
+
+    bool thrown {false};
+    try {
+        SplitOrderedHashTable<int, int> invalid(1);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: basic operations
+    ht.put("one", 1);
+    ht.put("two", 2);
+    ht.put("three", 3);
+    ht.put("one", 11);
+    assert(ht.get("one") == 11);
+    assert(ht.containsKey("two"));
+    assert(!ht.containsKey("four"));
+    assert(ht.getOrDefault("four", 4) == 4);
+    assert(ht.size() == 3);
+
+    int out {0};
+    assert(ht.tryGet("three", out) && out == 3);
+    assert(!ht.tryGet("four", out));
+
+    ht.remove("two");
+    assert(!ht.containsKey("two"));
+    assert(ht.size() == 2);
+
+    thrown = false;
+    try {
+        ht.get("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        ht.remove("two");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    ht.clear();
+    assert(ht.isEmpty());
+    assert(!ht.containsKey("one"));
+
+    ht.put("one", 1);
+    assert(ht.get("one") == 1);
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: growth adds buckets without moving entries
+    SplitOrderedHashTable<int, double> stress_ht {2};
+
+    for (int i = 0; i < ELEMENTS; i++) stress_ht.put(i, static_cast<double>(i));
+
+    assert(stress_ht.size() == ELEMENTS);
+    assert(stress_ht.buckets() >= ELEMENTS / SPLIT_MAX_LF / 2);
+
+    for (int i = 0; i < ELEMENTS; i++) assert(stress_ht.get(i) == i);
+
+    for (int i = 0; i < ELEMENTS; i += 2) stress_ht.remove(i);
+
+    assert(stress_ht.size() == ELEMENTS / 2);
+
+    for (int i = 0; i < ELEMENTS; i++) assert(stress_ht.containsKey(i) == (i % 2 == 1));
+
+    for (int i = 1; i < ELEMENTS; i += 2) stress_ht.remove(i);
+
+    assert(stress_ht.isEmpty());
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: full hash collisions are told apart by key
+    SplitOrderedHashTable<int, int, ConstantHash> colliding;
+
+    for (int i = 0; i < 100; i++) colliding.put(i, i);
+
+    for (int i = 0; i < 100; i += 3) colliding.remove(i);
+
+    for (int i = 0; i < 100; i++) assert(colliding.getOrDefault(i, -1) == (i % 3 == 0 ? -1 : i));
+
+    colliding.put(0, 7);
+    assert(colliding.get(0) == 7);
+    assert(colliding.size() == 67);
+
+    std::cout << "Test 4 passed\n";
+
+    // Test 5: concurrent inserts and removes of disjoint key ranges
+    SplitOrderedHashTable<int, int> shared {2};
+    std::thread workers[THREADS];
+
+    for (int t = 0; t < THREADS; t++) {
+        workers[t] = std::thread([&shared, t]() {
+            int first = t * ELEMENTS;
+
+            for (int i = first; i < first + ELEMENTS / 10; i++) shared.put(i, i);
+
+            for (int i = first; i < first + ELEMENTS / 10; i += 2) shared.remove(i);
+        });
+    }
+
+    for (int t = 0; t < THREADS; t++) workers[t].join();
+
+    assert(shared.size() == THREADS * ELEMENTS / 20);
+
+    for (int t = 0; t < THREADS; t++) {
+        for (int i = t * ELEMENTS; i < t * ELEMENTS + ELEMENTS / 10; i++) {
+            assert(shared.getOrDefault(i, -1) == (i % 2 == 1 ? i : -1));
+        }
+    }
+
+    std::cout << "Test 5 passed\n";
+
+    // Test 6: every thread fights over the same few keys
+    SplitOrderedHashTable<int, int> contended;
+
+    for (int t = 0; t < THREADS; t++) {
+        workers[t] = std::thread([&contended, t]() {
+            for (int round = 0; round < 2000; round++) {
+                int key = (round * 7 + t) % 64;
+
+                if (!contended.containsKey(key)) contended.put(key, t);
+
+                try {
+                    contended.remove((key + 32) % 64);
+                } catch (const std::out_of_range&) {
+                }
+            }
+        });
+    }
+
+    for (int t = 0; t < THREADS; t++) workers[t].join();
+
+    int present {0};
+
+    for (int key = 0; key < 64; key++) present += contended.containsKey(key);
+
+    assert(present == contended.size());
+    assert(present <= 64);
+
+    std::cout << "Test 6 passed\n";
+
+    // Test 7: readers see stable keys while writers churn, update and grow the table
+    SplitOrderedHashTable<int, std::string> mixed;
+
+    for (int i = 0; i < ELEMENTS; i += 2) mixed.put(i, std::to_string(i));
+
+    std::atomic<bool> done {false};
+    bool ok[THREADS];
+
+    for (int t = 0; t < THREADS / 2; t++) {
+        workers[t] = std::thread([&mixed, &done, &ok, t]() {
+            ok[t] = true;
+
+            while (!done.load()) {
+                for (int i = 0; i < ELEMENTS; i += 2) {
+                    if (mixed.getOrDefault(i, "") != std::to_string(i)) ok[t] = false;
+                }
+            }
+        });
+    }
+
+    for (int t = THREADS / 2; t < THREADS; t++) {
+        workers[t] = std::thread([&mixed, t]() {
+            for (int round = 0; round < 2; round++) {
+                for (int i = 1 + 2 * t; i < ELEMENTS * 2; i += THREADS) mixed.put(i, "odd");
+                // rewriting stable keys with the same contents
+                for (int i = 2 * t; i < ELEMENTS; i += THREADS) mixed.put(i, std::to_string(i));
+                for (int i = 1 + 2 * t; i < ELEMENTS * 2; i += THREADS) mixed.remove(i);
+            }
+        });
+    }
+
+    for (int t = THREADS / 2; t < THREADS; t++) workers[t].join();
+
+    done.store(true);
+
+    for (int t = 0; t < THREADS / 2; t++) {
+        workers[t].join();
+        assert(ok[t]);
+    }
+
+    assert(mixed.size() == ELEMENTS / 2);
+
+    std::cout << "Test 7 passed\n";
+
+    // Test 8: several writers retire nodes and values while readers hold them; more threads than
+    // cores, so threads are preempted inside pin and nothing may be freed early
+    SplitOrderedHashTable<int, Poisoned> churn;
+    const int churnKeys {256};
+
+    for (int key = 0; key < churnKeys; key++) churn.put(key, Poisoned(key));
+
+    done.store(false);
+
+    for (int t = 0; t < THREADS / 2; t++) {
+        workers[t] = std::thread([&churn, &done, &ok, t]() {
+            ok[t] = true;
+
+            while (!done.load()) {
+                for (int key = 0; key < churnKeys; key++) {
+                    Poisoned value = churn.getOrDefault(key, Poisoned(key));
+
+                    if (!value.valid() || value.key != key) ok[t] = false;
+                }
+            }
+        });
+    }
+
+    for (int t = THREADS / 2; t < THREADS; t++) {
+        workers[t] = std::thread([&churn, t]() {
+            for (int round = 0; round < 200; round++) {
+                for (int key = t; key < churnKeys; key += 3) {
+                    churn.put(key, Poisoned(key));
+
+                    try {
+                        churn.remove((key + round) % churnKeys);
+                    } catch (const std::out_of_range&) {
+                    }
+
+                    churn.put((key + round) % churnKeys, Poisoned((key + round) % churnKeys));
+                }
+            }
+        });
+    }
+
+    for (int t = THREADS / 2; t < THREADS; t++) workers[t].join();
+
+    done.store(true);
+
+    for (int t = 0; t < THREADS / 2; t++) {
+        workers[t].join();
+        assert(ok[t]);
+    }
+
+    for (int key = 0; key < churnKeys; key++) assert(churn.get(key).valid());
+
+    std::cout << "Test 8 passed\n";
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}
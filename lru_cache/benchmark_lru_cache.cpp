@@ -0,0 +1,85 @@
+#include "lru_cache.h"
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+const int universe = 1'000'000;
+const int requests = 10'000'000;
+
+// Zipf(s) ranks by inverse CDF; rank r is scrambled into a key so hot keys are spread over buckets
+std::vector<int> zipfTrace(double s) {
+    std::vector<double> cdf(universe);
+    double total {0.0};
+
+    for (int r = 0; r < universe; r++) {
+        total += 1.0 / std::pow(r + 1, s);
+        cdf[r] = total;
+    }
+
+    std::vector<int> trace(requests);
+    unsigned long long state {12345};
+
+    for (int i = 0; i < requests; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        double u = static_cast<double>(state >> 11) / 9007199254740992.0 * total;
+
+        int low {0}, high {universe - 1};
+
+        while (low < high) {
+            int mid = (low + high) / 2;
+
+            if (cdf[mid] < u) low = mid + 1;
+            else high = mid;
+        }
+
+        trace[i] = static_cast<int>((low * 2654435761ULL) % 1'000'000'007ULL);
+    }
+
+    return trace;
+}
+
+// read-through cache: a miss loads the value and puts it
+void run(const std::vector<int>& trace, int capacity, EvictionPolicy policy) {
+    using namespace std::chrono;
+
+    LRUCache<int, int> cache(capacity, policy);
+    long long sum {0};
+
+    auto start = high_resolution_clock::now();
+
+    for (int key : trace) {
+        int* value = cache.find(key);
+
+        if (value) sum += *value;
+        else cache.put(key, key);
+    }
+
+    auto end = high_resolution_clock::now();
+
+    if (sum == 42) std::cout << "";
+
+    double seconds = duration_cast<microseconds>(end - start).count() / 1e6;
+
+    std::cout << (policy == EvictionPolicy::LRU ? "  LRU   " : "  CLOCK ")
+              << "hit rate " << cache.hitRate() * 100 << "%, "
+              << requests / seconds / 1e6 << " Mops/s\n";
+}
+
+int main() {
+    double skews[3] {0.8, 0.99, 1.2};
+    int capacities[2] {universe / 100, universe / 10};
+
+    for (double s : skews) {
+        std::vector<int> trace = zipfTrace(s);
+
+        for (int capacity : capacities) {
+            std::cout << "Zipf s=" << s << ", capacity " << capacity << ":\n";
+
+            run(trace, capacity, EvictionPolicy::LRU);
+            run(trace, capacity, EvictionPolicy::CLOCK);
+        }
+    }
+
+    return 0;
+}
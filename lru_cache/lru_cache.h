@@ -0,0 +1,330 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+
+#include "../hash_table/node_pool.h"
+#include "../hash_table/hash_policy.h"
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+static const float CACHE_MAX_LF {0.75f};
+
+
+enum class EvictionPolicy { LRU, CLOCK };
+
+
+// one allocation per entry: the hash chain link and the recency links live in the same node
+template<typename K, typename V>
+struct cache_node {
+    K key;
+    V value;
+    std::size_t hash;
+    // hash chain
+    cache_node* chain;
+    // circular recency list
+    cache_node* prev;
+    cache_node* next;
+    // CLOCK only: touched since the hand last passed
+    bool referenced;
+
+    template<typename KK, typename VV>
+    cache_node(std::size_t h, KK&& k, VV&& v)
+        : key(std::forward<KK>(k)), value(std::forward<VV>(v)), hash(h), chain(nullptr), prev(this), next(this), referenced(false) {}
+};
+
+
+// bounded key-value cache with O(1) get, put and eviction.
+// LRU: a hit moves the entry to the front of the recency list, the back is evicted.
+// CLOCK (second chance): a hit only sets a bit; the hand sweeps the list, clearing bits,
+// and evicts the first entry it finds unreferenced, so hits never relink nodes
+template<typename K, typename V, typename Hash = DefaultHash<K>>
+class LRUCache {
+private:
+    cache_node<K, V>** table;
+    int buckets;
+    int _capacity;
+    int _size;
+    EvictionPolicy policy;
+
+    // LRU: most recently used entry, its prev is the least recently used one.
+    // CLOCK: the hand, next entry to examine; new entries go right behind it
+    cache_node<K, V>* head;
+
+    NodePool<cache_node<K, V>> pool;
+    Hash hasher;
+
+    long long _hits;
+    long long _misses;
+    long long _evictions;
+
+    cache_node<K, V>** bucket(std::size_t h) const { return &table[h & (buckets - 1)]; }
+
+    cache_node<K, V>* findNode(const K& key, std::size_t h) const {
+        cache_node<K, V>* temp = *bucket(h);
+
+        while (temp) {
+            if (temp->hash == h && temp->key == key) return temp;
+
+            temp = temp->chain;
+        }
+
+        return nullptr;
+    }
+
+    // insert n into the circular list just before head
+    void linkBefore(cache_node<K, V>* n) {
+        if (!head) {
+            n->prev = n->next = n;
+            head = n;
+            return;
+        }
+
+        n->next = head;
+        n->prev = head->prev;
+        head->prev->next = n;
+        head->prev = n;
+    }
+
+    void unlink(cache_node<K, V>* n) {
+        if (n->next == n) {
+            head = nullptr;
+            return;
+        }
+
+        if (head == n) head = n->next;
+
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+    }
+
+    void touch(cache_node<K, V>* n) {
+        if (policy == EvictionPolicy::CLOCK) {
+            n->referenced = true;
+            return;
+        }
+
+        // already the most recent entry
+        if (head == n) return;
+
+        unlink(n);
+        linkBefore(n);
+        head = n;
+    }
+
+    void unchain(cache_node<K, V>* n) {
+        cache_node<K, V>** link = bucket(n->hash);
+
+        while (*link != n) link = &(*link)->chain;
+
+        *link = n->chain;
+    }
+
+    cache_node<K, V>* victim() {
+        if (policy == EvictionPolicy::LRU) return head->prev;
+
+        // second chance: every referenced entry the hand passes loses its bit
+        while (head->referenced) {
+            head->referenced = false;
+            head = head->next;
+        }
+
+        return head;
+    }
+
+    void evict() {
+        cache_node<K, V>* n = victim();
+
+        unchain(n);
+        unlink(n);
+        pool.destroy(n);
+
+        _size--;
+        _evictions++;
+    }
+
+    static int bucketsFor(int capacity) {
+        int rounded {2};
+
+        while (capacity > rounded * CACHE_MAX_LF) rounded *= 2;
+
+        return rounded;
+    }
+
+    void init(int capacity, EvictionPolicy p) {
+        if (capacity < 1) throw std::invalid_argument("Cache capacity must be at least 1");
+
+        _capacity = capacity;
+        policy = p;
+        buckets = bucketsFor(capacity);
+        table = new cache_node<K, V>*[buckets]();
+        head = nullptr;
+        _size = 0;
+        _hits = _misses = _evictions = 0;
+    }
+
+    void cleanup() {
+        while (head) {
+            cache_node<K, V>* n = head;
+            unlink(n);
+            n->~cache_node<K, V>();
+        }
+
+        delete[] table;
+        pool.releaseAll();
+    }
+
+    // replay the other cache from its oldest entry to its newest, so recency order carries over
+    void copyFrom(const LRUCache<K, V, Hash>& other) {
+        init(other._capacity, other.policy);
+        pool.reserve(other._size);
+
+        if (other.head) {
+            // LRU: oldest is head->prev; CLOCK: the hand and its successors, in sweep order
+            cache_node<K, V>* start = policy == EvictionPolicy::LRU ? other.head->prev : other.head;
+            cache_node<K, V>* temp = start;
+
+            do {
+                cache_node<K, V>* n = pool.create(temp->hash, temp->key, temp->value);
+                n->referenced = temp->referenced;
+                n->chain = *bucket(n->hash);
+                *bucket(n->hash) = n;
+
+                linkBefore(n);
+                if (policy == EvictionPolicy::LRU) head = n;
+
+                temp = policy == EvictionPolicy::LRU ? temp->prev : temp->next;
+            } while (temp != start);
+        }
+
+        _size = other._size;
+        _hits = other._hits;
+        _misses = other._misses;
+        _evictions = other._evictions;
+    }
+
+public:
+    explicit LRUCache(int capacity, EvictionPolicy p = EvictionPolicy::LRU) { init(capacity, p); }
+
+    ~LRUCache() { cleanup(); }
+
+    LRUCache(const LRUCache<K, V, Hash>& other) { copyFrom(other); }
+
+    LRUCache<K, V, Hash>& operator=(const LRUCache<K, V, Hash>& other) {
+        // check self-assignment
+        if (this == &other) return *this;
+
+        cleanup();
+        copyFrom(other);
+
+        return *this;
+    }
+
+    // insert or update; a new key evicts one entry when the cache is full
+    template<typename KK = K, typename VV = V>
+    void put(KK&& key, VV&& value) {
+        if constexpr (!std::is_same<typename std::decay<KK>::type, K>::value) {
+            put(K(std::forward<KK>(key)), std::forward<VV>(value));
+        } else {
+            std::size_t h = hasher(key);
+            cache_node<K, V>* n = findNode(key, h);
+
+            if (n) {
+                n->value = std::forward<VV>(value);
+                touch(n);
+                return;
+            }
+
+            if (_size == _capacity) evict();
+
+            n = pool.create(h, std::forward<KK>(key), std::forward<VV>(value));
+            n->chain = *bucket(h);
+            *bucket(h) = n;
+
+            // LRU: front of the list; CLOCK: behind the hand, the last entry it will reach
+            linkBefore(n);
+            if (policy == EvictionPolicy::LRU) head = n;
+
+            _size++;
+        }
+    }
+
+    // pointer to the cached value or nullptr; a hit counts as a use
+    V* find(const K& key) {
+        cache_node<K, V>* n = findNode(key, hasher(key));
+
+        if (!n) {
+            _misses++;
+            return nullptr;
+        }
+
+        _hits++;
+        touch(n);
+
+        return &n->value;
+    }
+
+    bool tryGet(const K& key, V& out) {
+        V* value = find(key);
+
+        if (!value) return false;
+
+        out = *value;
+        return true;
+    }
+
+    const V& get(const K& key) {
+        V* value = find(key);
+
+        if (!value) throw std::out_of_range("Key not found");
+
+        return *value;
+    }
+
+    V getOrDefault(const K& key, const V& value) {
+        V* found = find(key);
+
+        return found ? *found : value;
+    }
+
+    // membership test that does not count as a use
+    bool containsKey(const K& key) const { return findNode(key, hasher(key)) != nullptr; }
+
+    void remove(const K& key) {
+        cache_node<K, V>* n = findNode(key, hasher(key));
+
+        if (!n) throw std::out_of_range("Key not found");
+
+        unchain(n);
+        unlink(n);
+        pool.destroy(n);
+
+        _size--;
+    }
+
+    int size() const { return _size; }
+
+    int capacity() const { return _capacity; }
+
+    bool isEmpty() const { return _size == 0; }
+
+    EvictionPolicy evictionPolicy() const { return policy; }
+
+    long long hits() const { return _hits; }
+
+    long long misses() const { return _misses; }
+
+    long long evictions() const { return _evictions; }
+
+    double hitRate() const { return _hits + _misses ? static_cast<double>(_hits) / (_hits + _misses) : 0.0; }
+
+    void resetStats() { _hits = _misses = _evictions = 0; }
+
+    void clear() {
+        cleanup();
+        init(_capacity, policy);
+    }
+};
+
+#endif
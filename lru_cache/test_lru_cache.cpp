@@ -0,0 +1,197 @@
+#include "lru_cache.h"
+#include <cassert>
+#include <string>
+#include <iostream>
+
+
+constexpr int ELEMENTS {1'000'000};
+
+
+int main() {
+    // Test 1: constructor
+    LRUCache<std::string, int> cache(3);
+    assert(cache.isEmpty());
+    assert(cache.size() == 0);
+    assert(cache.capacity() == 3);
+    assert(cache.evictionPolicy() == EvictionPolicy::LRU);
+
+    bool thrown {false};
+
+    try {
+        LRUCache<int, int> invalid(0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    std::cout << "Test 1 passed\n";
+
+    // Test 2: basic operations
+    cache.put("one", 1);
+    cache.put("two", 2);
+    cache.put("three", 3);
+    assert(cache.size() == 3);
+    assert(cache.get("one") == 1);
+    assert(*cache.find("two") == 2);
+    assert(cache.containsKey("three"));
+    assert(!cache.containsKey("four"));
+    assert(cache.getOrDefault("four", 4) == 4);
+
+    int out {0};
+    assert(cache.tryGet("three", out) && out == 3);
+    assert(!cache.tryGet("four", out));
+
+    thrown = false;
+
+    try {
+        cache.get("four");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    std::cout << "Test 2 passed\n";
+
+    // Test 3: LRU eviction order
+    LRUCache<int, int> lru(3);
+    lru.put(1, 1);
+    lru.put(2, 2);
+    lru.put(3, 3);
+
+    // 1 becomes the most recent, so 2 is evicted next
+    lru.get(1);
+    lru.put(4, 4);
+    assert(!lru.containsKey(2));
+    assert(lru.containsKey(1) && lru.containsKey(3) && lru.containsKey(4));
+    assert(lru.evictions() == 1);
+
+    // an update also counts as a use
+    lru.put(3, 30);
+    lru.put(5, 5);
+    assert(!lru.containsKey(1));
+    assert(lru.get(3) == 30);
+
+    // containsKey does not
+    lru.containsKey(4);
+    lru.put(6, 6);
+    assert(!lru.containsKey(4));
+
+    std::cout << "Test 3 passed\n";
+
+    // Test 4: CLOCK gives referenced entries a second chance
+    LRUCache<int, int> clock(3, EvictionPolicy::CLOCK);
+    clock.put(1, 1);
+    clock.put(2, 2);
+    clock.put(3, 3);
+
+    clock.get(1);
+    clock.put(4, 4);
+    assert(clock.containsKey(1));
+    assert(!clock.containsKey(2));
+
+    // 1 lost its bit during the sweep and nothing else was touched
+    clock.get(3);
+    clock.put(5, 5);
+    assert(!clock.containsKey(1));
+    assert(clock.containsKey(3) && clock.containsKey(4) && clock.containsKey(5));
+    assert(clock.size() == 3);
+
+    std::cout << "Test 4 passed\n";
+
+    // Test 5: remove and hit statistics
+    lru.resetStats();
+    lru.remove(5);
+    assert(!lru.containsKey(5));
+    assert(lru.size() == 2);
+
+    thrown = false;
+
+    try {
+        lru.remove(5);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    lru.find(3);
+    lru.find(5);
+    lru.find(6);
+    lru.find(7);
+    assert(lru.hits() == 2 && lru.misses() == 2);
+    assert(lru.hitRate() == 0.5);
+
+    std::cout << "Test 5 passed\n";
+
+    // Test 6: copies keep contents and recency order
+    for (int p = 0; p < 2; p++) {
+        LRUCache<int, int> original(4, p ? EvictionPolicy::CLOCK : EvictionPolicy::LRU);
+
+        for (int i = 0; i < 4; i++) original.put(i, i);
+
+        original.get(0);
+
+        LRUCache<int, int> copy(original);
+        original.put(10, 10);
+        copy.put(10, 10);
+
+        for (int i = 0; i < 4; i++) assert(original.containsKey(i) == copy.containsKey(i));
+
+        LRUCache<int, int> assigned(1);
+        assigned.put(99, 99);
+        assigned = original;
+        assert(assigned.size() == 4);
+        assert(!assigned.containsKey(99));
+        assert(assigned.capacity() == 4);
+
+        assigned = assigned;
+        assert(assigned.size() == 4);
+    }
+
+    std::cout << "Test 6 passed\n";
+
+    // Test 7: clear
+    cache.clear();
+    assert(cache.isEmpty());
+    assert(!cache.containsKey("one"));
+    cache.put("one", 1);
+    assert(cache.get("one") == 1);
+
+    std::cout << "Test 7 passed\n";
+
+    // Test 8: capacity of one
+    LRUCache<int, int> single(1, EvictionPolicy::CLOCK);
+    single.put(1, 1);
+    single.get(1);
+    single.put(2, 2);
+    assert(single.size() == 1);
+    assert(single.containsKey(2) && !single.containsKey(1));
+
+    std::cout << "Test 8 passed\n";
+
+    // Test 9: stress, the cache never exceeds its capacity and keeps hot keys
+    for (int p = 0; p < 2; p++) {
+        LRUCache<int, int> stress(1000, p ? EvictionPolicy::CLOCK : EvictionPolicy::LRU);
+
+        // a hot set of 100 keys is read after every insert
+        for (int i = 0; i < ELEMENTS; i++) {
+            stress.put(i + 100, i);
+            stress.put(i % 100, i);
+        }
+
+        assert(stress.size() == 1000);
+
+        for (int i = 0; i < 100; i++) assert(stress.containsKey(i));
+
+        assert(stress.containsKey(ELEMENTS + 99));
+        assert(!stress.containsKey(100));
+    }
+
+    std::cout << "Test 9 passed\n";
+
+    std::cout << "All tests passed successfully\n";
+
+    return 0;
+}